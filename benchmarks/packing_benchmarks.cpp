@@ -0,0 +1,62 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+
+#include <accel/geometry>
+
+using namespace accel;
+
+// Packs a batch into a square bin and prints the best time of a few runs, how many items were placed and the
+// occupancy
+template<typename Packer>
+static void run(const char* name, unsigned bin, const std::vector<size2u>& glyphs)
+{
+	std::vector<rectangleu> placements(glyphs.size());
+	double best = 0;
+	std::size_t placed = 0;
+	double occupancy = 0;
+	for (int run = 0; run < 3; run++)
+	{
+		Packer packer(size2u(bin, bin));
+		auto start = std::chrono::steady_clock::now();
+		placed = packer.insert(glyphs.data(), glyphs.size(), placements.data());
+		double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		best = run == 0 ? elapsed : std::min(best, elapsed);
+		occupancy = packer.occupancy();
+	}
+
+	std::cout << std::setw(10) << name << std::setw(8) << glyphs.size() << std::setw(7) << bin
+		<< std::setw(12) << std::fixed << std::setprecision(3) << best << " ms"
+		<< std::setw(8) << placed << std::setw(9) << std::setprecision(3) << occupancy << "\n";
+}
+
+int main(int argc, char* argv[])
+{
+	std::mt19937 random(42);
+	std::uniform_int_distribution<unsigned> width(4, 28), height(10, 32);
+
+	std::cout << "    packer   items    bin        time    placed occupancy\n";
+
+	// Bins sized to take every item, so the time follows the item count
+	const struct { std::size_t items; unsigned bin; } cases[] = { { 500, 512 }, { 1000, 724 }, { 2000, 1024 }, { 4000, 1448 }, { 8000, 2048 } };
+	for (const auto& c : cases)
+	{
+		std::vector<size2u> glyphs;
+		for (std::size_t i = 0; i < c.items; i++)
+			glyphs.push_back(size2u(width(random), height(random)));
+
+		run<skyline_packer<unsigned>>("skyline", c.bin, glyphs);
+		run<maxrects_packer<unsigned>>("maxrects", c.bin, glyphs);
+	}
+
+	// A bin too small for the batch, where the tighter MaxRects placement fits more items
+	std::vector<size2u> overflow;
+	for (std::size_t i = 0; i < 600; i++)
+		overflow.push_back(size2u(width(random), height(random)));
+	run<skyline_packer<unsigned>>("skyline", 256, overflow);
+	run<maxrects_packer<unsigned>>("maxrects", 256, overflow);
+
+	return 0;
+}
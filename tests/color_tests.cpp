@@ -0,0 +1,245 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <stdexcept>
+
+#include <cassert>
+
+#include <accel/color>
+
+using namespace accel;
+
+static bool near(const colorf_rgb& a, const colorf_rgb& b, float tolerance)
+{
+	return std::fabs(a.x() - b.x()) <= tolerance && std::fabs(a.y() - b.y()) <= tolerance && std::fabs(a.z() - b.z()) <= tolerance;
+}
+
+static color_rgb rgb8(int r, int g, int b)
+{
+	return color_rgb(static_cast<unsigned char>(r), static_cast<unsigned char>(g), static_cast<unsigned char>(b));
+}
+
+static color_rgba rgba8(int r, int g, int b, int a)
+{
+	return color_rgba(static_cast<unsigned char>(r), static_cast<unsigned char>(g), static_cast<unsigned char>(b), static_cast<unsigned char>(a));
+}
+
+int main(int argc, char* argv[])
+{
+	// ----------------------------------------------------
+	// Kernels
+	// ----------------------------------------------------
+
+	// Every kernel level the CPU supports agrees with the scalar one
+	{
+		const auto& scalar = details::color_kernels_for(simd_level::scalar);
+
+		std::uint8_t bytes[4 * 11];
+		float floats[4 * 11];
+		for (std::size_t i = 0; i < 4 * 11; i++)
+		{
+			bytes[i] = static_cast<std::uint8_t>(i * 37 + 5);
+			floats[i] = static_cast<float>(i) / 40.0f - 0.05f;
+		}
+		floats[5] = std::numeric_limits<float>::quiet_NaN();
+		floats[6] = 0.0f;
+
+		for (auto level : { simd_level::sse2, simd_level::avx2, simd_level::avx512 })
+		{
+			if (!cpu_features::current().supports(level))
+				continue;
+			const auto& kernels = details::color_kernels_for(level);
+
+			for (std::size_t count = 0; count <= 4 * 11; count += 4)
+			{
+				float expected[4 * 11], actual[4 * 11];
+				std::uint8_t expected_bytes[4 * 11], actual_bytes[4 * 11];
+
+				scalar.unorm8_to_float(bytes, expected, count);
+				kernels.unorm8_to_float(bytes, actual, count);
+				assert(std::equal(expected, expected + count, actual));
+
+				scalar.float_to_unorm8(floats, expected_bytes, count);
+				kernels.float_to_unorm8(floats, actual_bytes, count);
+				assert(std::equal(expected_bytes, expected_bytes + count, actual_bytes));
+
+				for (bool alpha : { false, true })
+				{
+					scalar.srgb8_to_linear(bytes, expected, count, alpha);
+					kernels.srgb8_to_linear(bytes, actual, count, alpha);
+					assert(std::equal(expected, expected + count, actual));
+
+					scalar.linear_to_srgb8(floats, expected_bytes, count, alpha);
+					kernels.linear_to_srgb8(floats, actual_bytes, count, alpha);
+					assert(std::equal(expected_bytes, expected_bytes + count, actual_bytes));
+				}
+
+				// Skips the NaN, which would never compare equal
+				std::size_t premultiplied = std::min<std::size_t>(count, 4 * 9);
+				scalar.premultiply(floats + 8, expected, premultiplied);
+				kernels.premultiply(floats + 8, actual, premultiplied);
+				assert(std::equal(expected, expected + premultiplied, actual));
+
+				scalar.unpremultiply(floats + 8, expected, premultiplied);
+				kernels.unpremultiply(floats + 8, actual, premultiplied);
+				assert(std::equal(expected, expected + premultiplied, actual));
+			}
+		}
+	}
+
+	// ----------------------------------------------------
+	// Transfer functions
+	// ----------------------------------------------------
+
+	{
+		assert(srgb_to_linear(0.0f) == 0.0f);
+		assert(std::fabs(srgb_to_linear(1.0f) - 1.0f) <= 1e-6f);
+		assert(std::fabs(linear_to_srgb(srgb_to_linear(0.5f)) - 0.5f) <= 1e-6f);
+
+		// The LUT encoder matches the exact curve to within one code, and exactly for every decoded value
+		color_rgba codes[64];
+		for (std::size_t i = 0; i < 64; i++)
+			codes[i] = color_rgba(static_cast<unsigned char>(i * 4), static_cast<unsigned char>(i * 4 + 1), static_cast<unsigned char>(i * 4 + 2), static_cast<unsigned char>(i * 4 + 3));
+		colorf_rgba linear[64];
+		color_rgba encoded[64];
+		srgb_to_linear(codes, linear, 64);
+		linear_to_srgb(linear, encoded, 64);
+		for (std::size_t i = 0; i < 64; i++)
+		{
+			assert(encoded[i] == codes[i]);
+			assert(linear[i].w() == codes[i].w() / 255.0f || std::fabs(linear[i].w() - codes[i].w() / 255.0f) <= 1e-7f);
+			assert(std::fabs(linear[i].x() - srgb_to_linear(codes[i].x() / 255.0f)) <= 1e-6f);
+		}
+
+		std::vector<colorf_rgb> ramp(4097);
+		std::vector<color_rgb> ramp_encoded(ramp.size());
+		for (std::size_t i = 0; i < ramp.size(); i++)
+			ramp[i] = colorf_rgb(i / 4096.0f);
+		linear_to_srgb(ramp.data(), ramp_encoded.data(), ramp.size());
+		for (std::size_t i = 0; i < ramp.size(); i++)
+		{
+			float exact = linear_to_srgb(ramp[i].x()) * 255.0f + 0.5f;
+			assert(std::abs(int(ramp_encoded[i].x()) - int(exact)) <= 1);
+		}
+
+		colorf_rgb out_of_range[2] = { colorf_rgb(-1.0f, 2.0f, 0.0f), colorf_rgb(1.0f, 0.0f, 1.0f) };
+		color_rgb clamped[2];
+		linear_to_srgb(out_of_range, clamped, 2);
+		assert(clamped[0] == rgb8(0, 255, 0));
+		convert(out_of_range, clamped, 2);
+		assert(clamped[1] == rgb8(255, 0, 255));
+	}
+
+	// ----------------------------------------------------
+	// Color models
+	// ----------------------------------------------------
+
+	{
+		assert(near(rgb_to_hsv(colorf_rgb(1.0f, 0.0f, 0.0f)), colorf_rgb(0.0f, 1.0f, 1.0f), 1e-6f));
+		assert(near(rgb_to_hsv(colorf_rgb(0.0f, 0.5f, 0.0f)), colorf_rgb(1.0f / 3.0f, 1.0f, 0.5f), 1e-6f));
+		assert(near(rgb_to_hsv(colorf_rgb(0.25f)), colorf_rgb(0.0f, 0.0f, 0.25f), 1e-6f));
+		assert(near(hsv_to_rgb(colorf_rgb(2.0f / 3.0f, 1.0f, 1.0f)), colorf_rgb(0.0f, 0.0f, 1.0f), 1e-6f));
+		assert(near(hsv_to_rgb(colorf_rgb(1.5f, 0.5f, 1.0f)), colorf_rgb(0.5f, 1.0f, 1.0f), 1e-6f));
+
+		assert(near(rgb_to_ycbcr(colorf_rgb(1.0f)), colorf_rgb(1.0f, 0.5f, 0.5f), 1e-6f));
+		assert(near(rgb_to_ycbcr(colorf_rgb(0.0f)), colorf_rgb(0.0f, 0.5f, 0.5f), 1e-6f));
+
+		std::vector<colorf_rgba> pixels;
+		for (std::size_t i = 0; i < 1000; i++)
+			pixels.push_back(colorf_rgba((i % 10) / 9.0f, (i / 10 % 10) / 9.0f, (i / 100) / 9.0f, 0.5f));
+		std::vector<colorf_rgba> converted(pixels.size()), restored(pixels.size());
+
+		rgb_to_hsv(pixels.data(), converted.data(), pixels.size());
+		hsv_to_rgb(converted.data(), restored.data(), pixels.size());
+		for (std::size_t i = 0; i < pixels.size(); i++)
+		{
+			assert((restored[i] - pixels[i]).length() <= 1e-5f);
+			assert(converted[i].w() == 0.5f);
+		}
+
+		rgb_to_ycbcr(pixels.data(), converted.data(), pixels.size());
+		ycbcr_to_rgb(converted.data(), restored.data(), pixels.size());
+		for (std::size_t i = 0; i < pixels.size(); i++)
+			assert((restored[i] - pixels[i]).length() <= 1e-4f);
+	}
+
+	// ----------------------------------------------------
+	// Alpha
+	// ----------------------------------------------------
+
+	{
+		colorf_rgba colors[3] = { colorf_rgba(1.0f, 0.5f, 0.25f, 0.5f), colorf_rgba(1.0f, 1.0f, 1.0f, 0.0f), colorf_rgba(0.2f, 0.4f, 0.6f, 1.0f) };
+		colorf_rgba premultiplied[3], restored[3];
+		premultiply(colors, premultiplied, 3);
+		unpremultiply(premultiplied, restored, 3);
+		assert(premultiplied[0] == colorf_rgba(0.5f, 0.25f, 0.125f, 0.5f));
+		assert(restored[0] == colors[0]);
+		assert(restored[1] == colorf_rgba(0.0f, 0.0f, 0.0f, 0.0f));
+		assert(restored[2] == colors[2]);
+
+		color_rgba bytes[3] = { rgba8(255, 128, 0, 128), rgba8(200, 100, 50, 0), rgba8(10, 20, 30, 255) };
+		color_rgba bytes_premultiplied[3], bytes_restored[3];
+		premultiply(bytes, bytes_premultiplied, 3);
+		unpremultiply(bytes_premultiplied, bytes_restored, 3);
+		assert(bytes_premultiplied[0] == rgba8(128, 64, 0, 128));
+		assert(bytes_premultiplied[1] == rgba8(0, 0, 0, 0));
+		assert(bytes_restored[0] == rgba8(255, 128, 0, 128));
+		assert(bytes_restored[2] == bytes[2]);
+	}
+
+	// ----------------------------------------------------
+	// Tiling
+	// ----------------------------------------------------
+
+	// Splitting the work over threads gives the same pixels as a single pass
+	{
+		std::vector<color_rgba> image(100003);
+		for (std::size_t i = 0; i < image.size(); i++)
+			image[i] = color_rgba(static_cast<unsigned char>(i), static_cast<unsigned char>(i >> 3), static_cast<unsigned char>(i >> 7), static_cast<unsigned char>(i * 7));
+
+		std::vector<colorf_rgba> single(image.size()), tiled(image.size());
+		srgb_to_linear(image.data(), single.data(), image.size());
+		tiling options;
+		options.threads = 4;
+		options.tile_size = 4096;
+		srgb_to_linear(image.data(), tiled.data(), image.size(), options);
+		assert(single == tiled);
+
+		std::vector<color_rgba> back(image.size());
+		options.threads = 0;
+		linear_to_srgb(tiled.data(), back.data(), back.size(), options);
+		assert(back == image);
+
+		std::size_t visited = 0;
+		std::atomic<std::size_t> covered(0);
+		details::parallel_tiles(0, options, [&](std::size_t, std::size_t) { visited++; });
+		details::parallel_tiles(10000, options, [&](std::size_t begin, std::size_t end) { covered += end - begin; });
+		assert(visited == 0);
+		assert(covered == 10000);
+
+		// A throwing tile stops the batch and the exception reaches the caller, whichever thread ran it
+		for (std::size_t failing : { std::size_t(0), std::size_t(37), std::size_t(99) })
+		{
+			options.threads = 4;
+			options.tile_size = 1;
+			bool caught = false;
+			try
+			{
+				details::parallel_tiles(100, options, [&](std::size_t begin, std::size_t)
+				{
+					if (begin == failing)
+						throw std::runtime_error("tile failed");
+				});
+			}
+			catch (const std::runtime_error& error)
+			{
+				caught = std::string(error.what()) == "tile failed";
+			}
+			assert(caught);
+		}
+	}
+
+	std::cout << "All tests completed successfully.\n";
+
+	return 0;
+}
@@ -0,0 +1,224 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+
+#include <cassert>
+
+#include <accel/format>
+
+using namespace accel;
+
+template<typename Value>
+static std::string text(const Value& value, char separator = ' ')
+{
+	char buffer[max_chars<Value>()];
+	to_chars_result result = to_chars(buffer, buffer + sizeof(buffer), value, separator);
+	assert(result.ec == std::errc());
+	return std::string(buffer, result.ptr);
+}
+
+template<typename Value>
+static Value parse(const std::string& text, char separator = ' ')
+{
+	Value value;
+	from_chars_result result = from_chars(text.data(), text.data() + text.size(), value, separator);
+	assert(result.ec == std::errc() && result.ptr == text.data() + text.size());
+	return value;
+}
+
+int main(int argc, char* argv[])
+{
+	// ----------------------------------------------------
+	// Scalars
+	// ----------------------------------------------------
+
+	// Floating-point values use the shortest text that round trips, fixed or scientific
+	{
+		assert(text(0.1f) == "0.1");
+		assert(text(0.1) == "0.1");
+		assert(text(1.0f / 3.0f) == "0.33333334");
+		assert(text(100.0f) == "100");
+		assert(text(-2.5) == "-2.5");
+		assert(text(0.001) == "0.001");
+		assert(text(1e-5) == "1e-05");
+		assert(text(1e16) == "1e+16");
+		assert(text(123456789.0f) == "123456792");
+		assert(text(1.7976931348623157e308) == "1.7976931348623157e+308");
+		assert(text(5e-324) == "5e-324");
+		assert(text(-0.0f) == "-0" && text(0.0) == "0");
+		assert(text(std::numeric_limits<float>::infinity()) == "inf");
+		assert(text(-std::numeric_limits<double>::infinity()) == "-inf");
+		assert(text(std::numeric_limits<double>::quiet_NaN()) == "nan");
+	}
+
+	// Interval edges: powers of two with a narrower gap below, subnormals, limits and long exact integers
+	{
+		assert(text(1e23) == "1e+23");
+		assert(text(std::ldexp(1.0f, -100)) == "7.888609e-31");
+		assert(text(std::nextafter(1.0, 2.0)) == "1.0000000000000002");
+		assert(text(std::nextafter(1.0f, 0.0f)) == "0.99999994");
+		assert(text(1.2345678901234567e-7) == "1.2345678901234566e-07");
+		assert(text(std::numeric_limits<float>::denorm_min()) == "1e-45");
+		assert(text(std::numeric_limits<float>::min()) == "1.1754944e-38");
+		assert(text(std::numeric_limits<float>::max()) == "3.4028235e+38");
+		assert(text(std::numeric_limits<double>::min()) == "2.2250738585072014e-308");
+		assert(text(9007199254740992.0) == "9007199254740992");
+		assert(text(8.589973e9f) == "8589973504");
+		assert(text(2.82879384806159e17) == "282879384806159008");
+		assert(text(2e21) == "2e+21");
+		assert(text(std::ldexp(1.0, 64)) == "18446744073709551616");
+		assert(text(std::ldexp(1.0, 70)) == "1180591620717411303424");
+	}
+
+	// Random values of both precisions round trip through their shortest text
+	{
+		std::mt19937_64 random(1);
+		for (std::size_t i = 0; i < 20000; i++)
+		{
+			std::uint64_t bits = random();
+			std::uint32_t low = static_cast<std::uint32_t>(bits);
+			float f;
+			double d;
+			std::memcpy(&f, &low, sizeof(f));
+			std::memcpy(&d, &bits, sizeof(d));
+			if (i % 2 == 0)
+			{
+				f = std::ldexp(float(bits % 1000) + 1.0f, int(bits % 64) - 32);
+				d = std::ldexp(double(bits % 100000) + 1.0, int(bits % 200) - 100);
+			}
+			if (!std::isnan(f))
+				assert(parse<float>(text(f)) == f);
+			if (!std::isnan(d))
+				assert(parse<double>(text(d)) == d);
+		}
+	}
+
+	// Parsing follows std::from_chars
+	{
+		assert(parse<double>("00012.5000e-2") == 0.125);
+		assert(parse<double>(".5") == 0.5 && parse<double>("5.") == 5.0);
+		assert(parse<float>("-Infinity") == -std::numeric_limits<float>::infinity());
+		assert(std::isnan(parse<double>("nan(123)")));
+		assert(parse<double>("123456789012345678901234567890") == 123456789012345678901234567890.0);
+		assert(parse<double>("2.2250738585072011e-308") == 2.2250738585072011e-308);
+		assert(parse<float>("16777217") == 16777216.0f);
+
+		double value = 7.0;
+		std::string partial = "1.5e+";
+		from_chars_result result = from_chars(partial.data(), partial.data() + partial.size(), value);
+		assert(result.ec == std::errc() && result.ptr == partial.data() + 3 && value == 1.5);
+
+		for (const char* invalid : { "", " 1", "+1", ".", "-", "e5", "x" })
+		{
+			result = from_chars(invalid, invalid + std::strlen(invalid), value);
+			assert(result.ec == std::errc::invalid_argument && result.ptr == invalid && value == 1.5);
+		}
+		for (const char* out_of_range : { "1e400", "-1e400", "1e-400" })
+		{
+			result = from_chars(out_of_range, out_of_range + std::strlen(out_of_range), value);
+			assert(result.ec == std::errc::result_out_of_range && value == 1.5);
+		}
+	}
+
+	// Integers of every width, with overflow detection
+	{
+		assert(text(0) == "0");
+		assert(text(std::numeric_limits<std::int64_t>::min()) == "-9223372036854775808");
+		assert(text(std::numeric_limits<std::uint64_t>::max()) == "18446744073709551615");
+		assert(text(std::int8_t(-128)) == "-128");
+		assert(parse<std::int64_t>("-9223372036854775808") == std::numeric_limits<std::int64_t>::min());
+		assert(parse<std::uint8_t>("255") == 255);
+
+		std::uint8_t byte = 3;
+		std::string overflow = "256";
+		assert(from_chars(overflow.data(), overflow.data() + 3, byte).ec == std::errc::result_out_of_range && byte == 3);
+		std::string negative = "-1";
+		assert(from_chars(negative.data(), negative.data() + 2, byte).ec == std::errc::invalid_argument);
+	}
+
+	// ----------------------------------------------------
+	// Compound values
+	// ----------------------------------------------------
+
+	// Every math type writes its components in order and reads them back
+	{
+		assert(text(vector3f(1.5f, -2.0f, 0.1f)) == "1.5 -2 0.1");
+		assert(text(point2d(3.0, 4.25), ',') == "3,4.25");
+		assert(text(size<2, int>(640, 480), 'x') == "640x480");
+		assert(text(rectanglef(1.0f, 2.0f, 3.0f, 4.0f)) == "1 2 3 4");
+		assert(text(degreesf(90.0f)) == "90");
+		assert(text(matrix2f(1.0f, 2.0f, 3.0f, 4.0f)) == "1 2 3 4");
+
+		assert(parse<vector3f>("1.5 -2 0.1") == vector3f(1.5f, -2.0f, 0.1f));
+		assert(parse<vector3f>("1.5 \t -2  0.1") == vector3f(1.5f, -2.0f, 0.1f));
+		assert(parse<point2d>("3 , 4.25", ',') == point2d(3.0, 4.25));
+		assert((parse<size<2, int>>("640x480", 'x') == size<2, int>(640, 480)));
+		assert(parse<rectanglef>("1 2 3 4") == rectanglef(1.0f, 2.0f, 3.0f, 4.0f));
+		assert(parse<degreesf>("90") == degreesf(90.0f));
+
+		matrix4f m = matrix4f::translate({ 1.0f, 2.0f, 3.0f }) * matrix4f::rotate_z(radiansf(0.3f));
+		assert(parse<matrix4f>(text(m, ','), ',') == m);
+
+		vector3f v(1.0f, 2.0f, 3.0f);
+		for (const char* invalid : { "1 2", "1,2,3", "1 2 x", "" })
+		{
+			assert(from_chars(invalid, invalid + std::strlen(invalid), v).ec == std::errc::invalid_argument);
+			assert(v == vector3f(1.0f, 2.0f, 3.0f));
+		}
+
+		char small[8];
+		to_chars_result result = to_chars(small, small + sizeof(small), vector3f(1.5f, 2.5f, 3.5f));
+		assert(result.ec == std::errc::value_too_large && result.ptr == small + sizeof(small));
+	}
+
+	// ----------------------------------------------------
+	// Lines
+	// ----------------------------------------------------
+
+	// Bulk formatting writes one value per line, and parsing reads it back
+	{
+		std::mt19937 random(2);
+		std::uniform_real_distribution<float> distribution(-1000.0f, 1000.0f);
+		std::vector<point3f> points(5000);
+		for (point3f& p : points)
+			p = point3f(distribution(random), distribution(random), distribution(random));
+
+		std::string csv;
+		format_lines(csv, points.data(), points.size(), ',');
+		assert(csv.substr(0, csv.find('\n')) == text(points[0], ','));
+		assert(std::count(csv.begin(), csv.end(), '\n') == std::ptrdiff_t(points.size()));
+
+		std::vector<point3f> read(points.size() + 1);
+		parse_lines_result parsed = parse_lines(csv.data(), csv.data() + csv.size(), read.data(), read.size(), ',');
+		assert(parsed.ec == std::errc() && parsed.count == points.size() && parsed.ptr == csv.data() + csv.size());
+		read.pop_back();
+		assert(read == points);
+
+		// The buffer overload stops cleanly when it runs out of room
+		std::vector<char> buffer(max_chars<point3f>() * 2);
+		assert(format_lines(buffer.data(), buffer.data() + buffer.size(), points.data(), 2).ec == std::errc());
+		assert(format_lines(buffer.data(), buffer.data() + 10, points.data(), 2).ec == std::errc::value_too_large);
+	}
+
+	// Blank lines, \r\n endings and surrounding blanks are accepted; a bad line stops parsing there
+	{
+		std::string lines = "\n  1 2\r\n\n3 4  \n5 6\n7 x\n9 10\n";
+		vector2f values[8];
+		parse_lines_result parsed = parse_lines(lines.data(), lines.data() + lines.size(), values, 8);
+		assert(parsed.ec == std::errc::invalid_argument && parsed.count == 3);
+		assert(parsed.ptr == lines.data() + lines.find("7 x"));
+		assert(values[0] == vector2f(1.0f, 2.0f) && values[2] == vector2f(5.0f, 6.0f));
+
+		parsed = parse_lines(lines.data(), lines.data() + lines.size(), values, 2);
+		assert(parsed.ec == std::errc() && parsed.count == 2 && parsed.ptr == lines.data() + lines.find("5 6"));
+
+		std::string trailing = "1 2 3\n";
+		parsed = parse_lines(trailing.data(), trailing.data() + trailing.size(), values, 8);
+		assert(parsed.ec == std::errc::invalid_argument && parsed.count == 0);
+	}
+
+	std::cout << "All tests completed successfully.\n";
+
+	return 0;
+}
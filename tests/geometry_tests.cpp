@@ -0,0 +1,495 @@
+#include <iostream>
+#include <vector>
+#include <random>
+
+#include <cassert>
+
+#include <accel/geometry>
+
+using namespace accel;
+
+// Pixel grid reference for region tests
+static std::vector<int> rasterize(const std::vector<rectanglei>& rectangles, int size)
+{
+	std::vector<int> grid(size * size);
+	for (const auto& r : rectangles)
+	{
+		for (int y = std::max(r.top(), 0); y < std::min(r.bottom(), size); y++)
+		{
+			for (int x = std::max(r.left(), 0); x < std::min(r.right(), size); x++)
+				grid[y * size + x]++;
+		}
+	}
+	return grid;
+}
+
+// Packs a batch and checks every placement keeps its size, stays in the bin and overlaps no other. Returns how
+// many were placed.
+template<typename Packer>
+static std::size_t pack_glyphs(Packer& packer, const std::vector<size2u>& glyphs, regioni& covered)
+{
+	std::vector<rectangleu> placements(glyphs.size());
+	std::size_t placed = packer.insert(glyphs.data(), glyphs.size(), placements.data());
+
+	std::vector<rectanglei> as_int;
+	double area = 0;
+	for (std::size_t i = 0; i < glyphs.size(); i++)
+	{
+		const rectangleu& r = placements[i];
+		if (r.width() == 0)
+			continue;
+		assert(r.width() == glyphs[i].width() && r.height() == glyphs[i].height());
+		assert(r.right() <= packer.bin_size().width() && r.bottom() <= packer.bin_size().height());
+		as_int.push_back(rectanglei(int(r.top()), int(r.left()), int(r.bottom()), int(r.right())));
+		area += double(r.width()) * r.height();
+	}
+	covered = regioni(as_int.data(), as_int.size());
+	assert(covered.area() == area);
+	assert(std::fabs(packer.occupancy() - area / (double(packer.bin_size().width()) * packer.bin_size().height())) < 1e-9);
+	return placed;
+}
+
+template<typename T>
+static rectangle_list<T> random_rectangles(std::mt19937& random, std::size_t count)
+{
+	std::uniform_int_distribution<int> position(-20, 80), extent(-5, 30);
+	rectangle_list<T> list;
+	for (std::size_t i = 0; i < count; i++)
+	{
+		T top = T(position(random)), left = T(position(random));
+		list.push_back(rectangle<T>(top, left, top + T(extent(random)), left + T(extent(random))));
+	}
+	return list;
+}
+
+template<typename T>
+static void check_kernels(std::mt19937& random)
+{
+	const auto& scalar = details::rectangle_kernels_for<T>(simd_level::scalar);
+	rectangle_list<T> list = random_rectangles<T>(random, 37);
+	rectangle<T> value(T(10), T(5), T(50), T(60));
+
+	for (auto level : { simd_level::sse2, simd_level::avx2, simd_level::avx512 })
+	{
+		if (!cpu_features::current().supports(level))
+			continue;
+		const auto& kernels = details::rectangle_kernels_for<T>(level);
+
+		std::uint8_t expected[37], actual[37];
+		scalar.intersects(value, details::columns(list), expected, list.size());
+		kernels.intersects(value, details::columns(list), actual, list.size());
+		assert(std::equal(expected, expected + 37, actual));
+
+		scalar.contains(value, details::columns(list), expected, list.size());
+		kernels.contains(value, details::columns(list), actual, list.size());
+		assert(std::equal(expected, expected + 37, actual));
+
+		rectangle_list<T> expected_clip, actual_clip;
+		expected_clip.resize(list.size());
+		actual_clip.resize(list.size());
+		scalar.clip(value, details::columns(list), expected_clip.tops(), expected_clip.lefts(), expected_clip.bottoms(), expected_clip.rights(), list.size());
+		kernels.clip(value, details::columns(list), actual_clip.tops(), actual_clip.lefts(), actual_clip.bottoms(), actual_clip.rights(), list.size());
+		for (std::size_t i = 0; i < list.size(); i++)
+			assert(expected_clip[i] == actual_clip[i]);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::mt19937 random(42);
+
+	// ----------------------------------------------------
+	// Rectangle lists
+	// ----------------------------------------------------
+
+	// Every kernel level the CPU supports agrees with the scalar one
+	check_kernels<float>(random);
+	check_kernels<int>(random);
+	check_kernels<double>(random);
+
+#if defined(ACCEL_SIMD_X86)
+	// The SIMD kernels spread every possible lane mask into 0/1 bytes
+	for (int mask = 0; mask < 256; mask++)
+	{
+		std::uint8_t bytes[8];
+		details::store_mask(bytes, mask);
+		for (int i = 0; i < 8; i++)
+			assert(bytes[i] == ((mask >> i) & 1));
+	}
+#endif
+
+	// Batch queries match the per-rectangle methods
+	{
+		rectangle_list<int> list = random_rectangles<int>(random, 300);
+		rectanglei value(0, 0, 40, 40);
+
+		std::vector<char> hits(list.size()), covered(list.size());
+		intersects(value, list, reinterpret_cast<bool*>(hits.data()));
+		contains(value, list, reinterpret_cast<bool*>(covered.data()));
+		std::vector<std::uint32_t> indices(list.size());
+		std::size_t found = select_intersecting(value, list, indices.data());
+
+		rectangle_list<int> clipped;
+		clip(value, list, clipped);
+
+		std::size_t expected_found = 0;
+		for (std::size_t i = 0; i < list.size(); i++)
+		{
+			rectanglei r = list[i];
+			bool overlap = value.intersection(r).valid();
+			assert(bool(hits[i]) == overlap);
+			assert(bool(covered[i]) == (r.top() >= 0 && r.left() >= 0 && r.bottom() <= 40 && r.right() <= 40));
+			assert(clipped[i] == value.intersection(r));
+			if (overlap)
+				assert(indices[expected_found++] == i);
+		}
+		assert(found == expected_found);
+	}
+
+	// Bounds and coalescing
+	{
+		rectanglei damage[5] = { rectanglei(0, 0, 10, 10), rectanglei(0, 10, 10, 20), rectanglei(2, 2, 5, 5), rectanglei(50, 50, 60, 60), rectanglei(5, 5, 5, 9) };
+		assert(bounds(damage, 5) == rectanglei(0, 0, 60, 60));
+		assert(bounds(damage + 4, 1) == rectanglei(0, 0, 0, 0));
+
+		std::size_t count = coalesce(damage, 5);
+		assert(count == 2);
+		std::vector<rectanglei> merged(damage, damage + count);
+		assert(std::find(merged.begin(), merged.end(), rectanglei(0, 0, 10, 20)) != merged.end());
+		assert(std::find(merged.begin(), merged.end(), rectanglei(50, 50, 60, 60)) != merged.end());
+	}
+
+	// ----------------------------------------------------
+	// Rectangle packing
+	// ----------------------------------------------------
+
+	// Glyph-like sizes pack densely without overlaps or leaving the bin
+	{
+		std::uniform_int_distribution<unsigned> width(4, 28), height(10, 32);
+		std::vector<size2u> glyphs;
+		for (int i = 0; i < 2000; i++)
+			glyphs.push_back(size2u(width(random), height(random)));
+		glyphs.push_back(size2u(0u, 5u));
+
+		skyline_packer<unsigned> skyline(size2u(1024u, 1024u));
+		regioni covered;
+		assert(pack_glyphs(skyline, glyphs, covered) == glyphs.size());
+
+		// Little space is lost below the highest placement
+		assert(covered.area() / (1024.0 * covered.bounds().bottom()) > 0.9);
+
+		maxrects_packer<unsigned> maxrects(size2u(1024u, 1024u));
+		assert(pack_glyphs(maxrects, glyphs, covered) == glyphs.size());
+
+		// Into a bin too small for all of them, MaxRects fits more than the skyline
+		std::vector<size2u> overflow(glyphs.begin(), glyphs.begin() + 600);
+		skyline_packer<unsigned> small_skyline(size2u(256u, 256u));
+		maxrects_packer<unsigned> small_maxrects(size2u(256u, 256u));
+		std::size_t skyline_placed = pack_glyphs(small_skyline, overflow, covered);
+		std::size_t maxrects_placed = pack_glyphs(small_maxrects, overflow, covered);
+		assert(skyline_placed < overflow.size() && maxrects_placed > skyline_placed);
+		assert(small_maxrects.occupancy() > small_skyline.occupancy());
+	}
+
+	// Incremental insertion fills the bin and then reports it is full
+	{
+		skyline_packer<int> packer(size2i(64, 32));
+		rectanglei placement;
+		for (int i = 0; i < 8; i++)
+		{
+			assert(packer.insert(size2i(16, 16), placement));
+			assert(placement.left() % 16 == 0 && placement.top() % 16 == 0);
+		}
+		assert(packer.occupancy() == 1.0);
+		assert(!packer.insert(size2i(1, 1), placement));
+
+		packer.clear();
+		assert(packer.insert(size2i(64, 10), placement) && placement == rectanglei(0, 0, 10, 64));
+		assert(packer.insert(size2i(30, 5), placement) && placement == rectanglei(10, 0, 15, 30));
+		assert(packer.insert(size2i(34, 3), placement) && placement == rectanglei(10, 30, 13, 64));
+		assert(!packer.insert(size2i(65, 1), placement));
+		assert(!packer.insert(size2i(10, 23), placement));
+	}
+
+	// ----------------------------------------------------
+	// Region
+	// ----------------------------------------------------
+
+	{
+		regioni a(rectanglei(0, 0, 10, 10));
+		regioni b(rectanglei(5, 5, 15, 15));
+		assert((a | b).area() == 175.0);
+		assert((a & b) == regioni(rectanglei(5, 5, 10, 10)));
+		assert((a - b).area() == 75.0);
+		assert((a ^ b).area() == 150.0);
+		assert((a - a).empty());
+		assert((a | b).bounds() == rectanglei(0, 0, 15, 15));
+		assert((a | b).contains(point2i(12, 12)));
+		assert(!(a | b).contains(point2i(2, 12)));
+		assert((a | b).intersects(rectanglei(9, 9, 20, 20)));
+		assert(!(a - b).intersects(rectanglei(6, 6, 9, 9)));
+
+		// Adjacent pieces collapse back into a single rectangle
+		regioni pieces(rectanglei(0, 0, 5, 10));
+		pieces |= regioni(rectanglei(5, 0, 10, 10));
+		pieces |= regioni(rectanglei(0, 10, 10, 20));
+		assert(pieces.rectangles().size() == 1);
+		assert(pieces == regioni(rectanglei(0, 0, 10, 20)));
+	}
+
+	// Set operations agree with a pixel grid, and equal sets compare equal however they were built
+	{
+		const int size = 64;
+		for (int round = 0; round < 20; round++)
+		{
+			std::uniform_int_distribution<int> position(0, 56), extent(1, 20);
+			std::vector<rectanglei> first, second;
+			for (int i = 0; i < 12; i++)
+			{
+				int top = position(random), left = position(random);
+				(i % 2 ? first : second).push_back(rectanglei(top, left, top + extent(random), left + extent(random)));
+			}
+
+			regioni a(first.data(), first.size());
+			regioni b(second.data(), second.size());
+			regioni incremental;
+			for (const auto& r : first)
+				incremental |= regioni(r);
+			assert(incremental == a);
+
+			std::vector<int> grid_a = rasterize(first, size), grid_b = rasterize(second, size);
+			std::vector<int> united = rasterize((a | b).rectangles(), size), common = rasterize((a & b).rectangles(), size);
+			std::vector<int> difference = rasterize((a - b).rectangles(), size), exclusive = rasterize((a ^ b).rectangles(), size);
+			for (int i = 0; i < size * size; i++)
+			{
+				bool in_a = grid_a[i] > 0, in_b = grid_b[i] > 0;
+				assert(united[i] == int(in_a || in_b));
+				assert(common[i] == int(in_a && in_b));
+				assert(difference[i] == int(in_a && !in_b));
+				assert(exclusive[i] == int(in_a != in_b));
+				assert(a.contains(point2i(i % size, i / size)) == in_a);
+			}
+
+			// Banded order: tops never decrease, and rectangles in a band are sorted and apart
+			regioni united_region = a | b;
+			const auto& rects = united_region.rectangles();
+			for (std::size_t i = 1; i < rects.size(); i++)
+			{
+				assert(rects[i - 1].top() <= rects[i].top());
+				if (rects[i - 1].top() == rects[i].top())
+					assert(rects[i - 1].bottom() == rects[i].bottom() && rects[i - 1].right() < rects[i].left());
+			}
+		}
+	}
+
+	// ----------------------------------------------------
+	// Predicates
+	// ----------------------------------------------------
+
+	// Points a few ulps off the line through (12, 12) and (24, 24), where a plain double determinant gets
+	// the sign wrong; the exact value is 12 * (y - x)
+	{
+		const double ulp = std::ldexp(1.0, -53);
+		for (int i = 0; i < 64; i++)
+		{
+			for (int j = 0; j < 64; j++)
+			{
+				point2d p(0.5 + i * ulp, 0.5 + j * ulp);
+				int expected = (p.y() > p.x()) - (p.y() < p.x());
+				assert(orient2d(p, point2d(12.0, 12.0), point2d(24.0, 24.0)) == expected);
+				assert(orient2d(point2d(12.0, 12.0), point2d(24.0, 24.0), p) == expected);
+				assert(orient2d(point2d(24.0, 24.0), point2d(12.0, 12.0), p) == -expected);
+			}
+		}
+
+		assert(orient2d(point2f(0.0f, 0.0f), point2f(1.0f, 0.0f), point2f(0.0f, 1.0f)) == 1);
+		assert(orient2d(point2i(0, 0), point2i(2, 2), point2i(7, 7)) == 0);
+		assert(orient2d(point2f(0.1f, 0.1f), point2f(0.3f, 0.3f), point2f(0.7f, 0.7f)) == 0);
+	}
+
+	// d near the plane z = x through a, b and c, which has the opposite sign of z - x
+	{
+		point3d a(0.0, 0.0, 0.0), b(24.0, 0.0, 24.0), c(0.0, 24.0, 0.0);
+		assert(orient3d(a, b, c, point3d(0.0, 0.0, 1.0)) == -1);
+		assert(orient3d(point3f(0.0f, 0.0f, 0.0f), point3f(1.0f, 0.0f, 0.0f), point3f(0.0f, 1.0f, 0.0f), point3f(0.0f, 0.0f, -1.0f)) == 1);
+
+		const double ulp = std::ldexp(1.0, -49);
+		for (int i = -16; i <= 16; i++)
+		{
+			for (int j = -16; j <= 16; j++)
+			{
+				point3d d(12.0 + i * ulp, 7.3, 12.0 + j * ulp);
+				int expected = (d.x() > d.z()) - (d.x() < d.z());
+				assert(orient3d(a, b, c, d) == expected);
+				assert(orient3d(b, a, c, d) == -expected);
+			}
+		}
+	}
+
+	// d near (2, 2) on the circle through (0, 0), (2, 0) and (0, 2), which is inside when the offsets sum below zero
+	{
+		point2d a(0.0, 0.0), b(2.0, 0.0), c(0.0, 2.0);
+		assert(incircle(a, b, c, point2d(1.0, 1.0)) == 1);
+		assert(incircle(a, c, b, point2d(1.0, 1.0)) == -1);
+		assert(incircle(a, b, c, point2d(3.0, 3.0)) == -1);
+		assert(incircle(point2i(0, 0), point2i(2, 0), point2i(0, 2), point2i(2, 2)) == 0);
+
+		const double ulp = std::ldexp(1.0, -51);
+		for (int i = -8; i <= 8; i++)
+		{
+			for (int j = -8; j <= 8; j++)
+			{
+				int expected = i + j < 0 ? 1 : (i == 0 && j == 0 ? 0 : -1);
+				assert(incircle(a, b, c, point2d(2.0 + i * ulp, 2.0 + j * ulp)) == expected);
+			}
+		}
+	}
+
+	// ----------------------------------------------------
+	// Point sets
+	// ----------------------------------------------------
+
+	// 2D hull of a square with points inside and along its sides is the four corners
+	{
+		std::mt19937 random(7);
+		std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+		std::vector<point2f> points;
+		for (int i = 0; i < 5000; i++)
+			points.push_back(point2f(coordinate(random), coordinate(random)));
+		for (int i = -4; i <= 4; i++)
+		{
+			points.push_back(point2f(i / 4.0f, -1.0f));
+			points.push_back(point2f(1.0f, i / 4.0f));
+		}
+		points.push_back(point2f(-1.0f, 1.0f));
+		points.push_back(point2f(-1.0f, 1.0f));
+
+		auto hull = convex_hull(points.data(), points.size());
+		assert(hull.size() == 4);
+		assert(points[hull[0]] == point2f(-1.0f, -1.0f) && points[hull[1]] == point2f(1.0f, -1.0f));
+		assert(points[hull[2]] == point2f(1.0f, 1.0f) && points[hull[3]] == point2f(-1.0f, 1.0f));
+
+		tiling options;
+		options.threads = 3;
+		options.tile_size = 700;
+		assert(convex_hull(points.data(), points.size(), options) == hull);
+
+		// Points on a circle are all on the hull, in counterclockwise order
+		std::vector<point2d> circle;
+		for (int i = 0; i < 360; i++)
+			circle.push_back(point2d(std::cos((i * 7 % 360) * 0.0174532925), std::sin((i * 7 % 360) * 0.0174532925)));
+		auto ring = convex_hull(circle.data(), circle.size(), options);
+		assert(ring.size() == 360);
+		for (std::size_t i = 0; i < ring.size(); i++)
+			assert(orient2d(circle[ring[i]], circle[ring[(i + 1) % ring.size()]], circle[ring[(i + 2) % ring.size()]]) == 1);
+	}
+
+	// 3D hull of a cube with points inside and on its faces encloses the cube's volume
+	{
+		std::mt19937 random(11);
+		std::uniform_int_distribution<int> coordinate(-100, 100);
+		std::vector<point3i> points;
+		for (int i = 0; i < 4000; i++)
+			points.push_back(point3i(coordinate(random), coordinate(random), coordinate(random)));
+		for (int i = 0; i < 8; i++)
+			points.push_back(point3i(i & 1 ? 100 : -100, i & 2 ? 100 : -100, i & 4 ? 100 : -100));
+
+		for (std::size_t tile : { std::size_t(100000), std::size_t(500) })
+		{
+			tiling options;
+			options.threads = 2;
+			options.tile_size = tile;
+			auto triangles = convex_hull(points.data(), points.size(), options);
+			std::vector<std::uint32_t> vertices(triangles);
+			std::sort(vertices.begin(), vertices.end());
+			vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+			assert(triangles.size() == (2 * vertices.size() - 4) * 3);
+
+			double volume = 0.0;
+			for (std::size_t t = 0; t < triangles.size(); t += 3)
+			{
+				vector3d corners[3];
+				for (int k = 0; k < 3; k++)
+				{
+					const auto& p = points[triangles[t + k]];
+					corners[k] = vector3d(double(p.x()), double(p.y()), double(p.z()));
+				}
+				volume += corners[0] * (corners[1] ^ corners[2]) / 6.0;
+				for (const auto& p : points)
+					assert(orient3d(points[triangles[t]], points[triangles[t + 1]], points[triangles[t + 2]], p) >= 0);
+			}
+			assert(std::fabs(volume - 200.0 * 200.0 * 200.0) <= 1e-6);
+		}
+
+		// Points on a sphere are all hull vertices, and a closed triangulated surface has 2V - 4 faces
+		std::vector<point3d> sphere;
+		std::normal_distribution<double> normal;
+		for (int i = 0; i < 500; i++)
+		{
+			vector3d direction(normal(random), normal(random), normal(random));
+			direction = direction / direction.length();
+			sphere.push_back(point3d(direction.x(), direction.y(), direction.z()));
+		}
+		auto triangles = convex_hull(sphere.data(), sphere.size());
+		assert(triangles.size() == (2 * sphere.size() - 4) * 3);
+
+		std::vector<point3f> plane(10, point3f(1.0f, 2.0f, 3.0f));
+		for (int i = 0; i < 10; i++)
+			plane[i].x() += float(i * i % 7);
+		assert(convex_hull(plane.data(), plane.size()).empty());
+	}
+
+	// Delaunay triangles have no point inside their circumcircle and cover the hull
+	{
+		std::mt19937 random(3);
+		std::uniform_real_distribution<double> coordinate(0.0, 100.0);
+		std::vector<point2d> points;
+		for (int i = 0; i < 1000; i++)
+			points.push_back(point2d(coordinate(random), coordinate(random)));
+		points.push_back(points[10]);
+
+		auto triangles = delaunay_triangulation(points.data(), points.size());
+		std::size_t hull = convex_hull(points.data(), points.size()).size();
+		assert(triangles.size() == (2 * 1000 - 2 - hull) * 3);
+		for (std::size_t t = 0; t < triangles.size(); t += 3)
+		{
+			const auto &a = points[triangles[t]], &b = points[triangles[t + 1]], &c = points[triangles[t + 2]];
+			assert(orient2d(a, b, c) == 1);
+			for (const auto& p : points)
+				assert(incircle(a, b, c, p) <= 0);
+		}
+
+		tiling options;
+		options.threads = 4;
+		options.tile_size = 100;
+		assert(delaunay_triangulation(points.data(), points.size(), options) == triangles);
+	}
+
+	// A grid is full of cocircular and collinear points; its triangulation still covers each cell with two triangles
+	{
+		std::vector<point2i> grid;
+		for (int y = 0; y < 20; y++)
+		{
+			for (int x = 0; x < 20; x++)
+				grid.push_back(point2i(x * 3, y * 3));
+		}
+		auto triangles = delaunay_triangulation(grid.data(), grid.size());
+		assert(triangles.size() == 2 * 19 * 19 * 3);
+		double area = 0.0;
+		for (std::size_t t = 0; t < triangles.size(); t += 3)
+		{
+			const auto &a = grid[triangles[t]], &b = grid[triangles[t + 1]], &c = grid[triangles[t + 2]];
+			area += ((b.x() - a.x()) * (c.y() - a.y()) - (b.y() - a.y()) * (c.x() - a.x())) / 2.0;
+			for (const auto& p : grid)
+				assert(incircle(a, b, c, p) <= 0);
+		}
+		assert(area == 57.0 * 57.0);
+
+		std::vector<point2f> line = { point2f(0.0f, 0.0f), point2f(1.0f, 1.0f), point2f(2.0f, 2.0f), point2f(0.0f, 0.0f) };
+		assert(delaunay_triangulation(line.data(), line.size()).empty());
+	}
+
+	std::cout << "All tests completed successfully.\n";
+
+	return 0;
+}
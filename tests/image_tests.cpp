@@ -0,0 +1,349 @@
+#include <iostream>
+#include <vector>
+
+#include <cassert>
+
+#include <accel/image>
+
+using namespace accel;
+
+static color_rgba rgba8(int r, int g, int b, int a)
+{
+	return color_rgba(static_cast<unsigned char>(r), static_cast<unsigned char>(g), static_cast<unsigned char>(b), static_cast<unsigned char>(a));
+}
+
+// Adds one to every pixel of counts covered by the block
+static void accumulate(std::vector<int>& counts, int width, const coverage_block& block)
+{
+	for (int bit = 0; bit < 64; bit++)
+	{
+		if (block.mask >> bit & 1)
+			counts[(block.top + bit / 8) * width + block.left + bit % 8]++;
+	}
+}
+
+static point2i subpixel(int x, int y)
+{
+	return point2i(x * (1 << subpixel_bits), y * (1 << subpixel_bits));
+}
+
+int main(int argc, char* argv[])
+{
+	// ----------------------------------------------------
+	// Kernels
+	// ----------------------------------------------------
+
+	// Every kernel level the CPU supports agrees with the scalar one
+	{
+		const auto& scalar = details::image_kernels_for(simd_level::scalar);
+		const unsigned width = 13, height = 9;
+
+		std::vector<float> floats(width * height);
+		std::vector<std::uint32_t> words(width * height);
+		std::vector<std::uint8_t> bytes(width * height * 4);
+		for (std::size_t i = 0; i < floats.size(); i++)
+		{
+			floats[i] = static_cast<float>((i * 7919) % 101) / 7.0f;
+			words[i] = static_cast<std::uint32_t>(i * 2654435761u);
+		}
+		for (std::size_t i = 0; i < bytes.size(); i++)
+			bytes[i] = static_cast<std::uint8_t>(i * 97 + 13);
+		const std::uint8_t border[4] = { 1, 2, 3, 4 };
+
+		details::warp_row rows[] =
+		{
+			{ 0.5f, 0.5f, 1.0f, 0.0f },
+			{ -2.25f, 3.7f, 0.83f, 0.31f },
+			{ 14.0f, -1.0f, -0.61f, 0.45f },
+			{ 6.5f, 4.5f, 0.0f, 0.0f },
+		};
+
+		for (auto level : { simd_level::sse2, simd_level::avx2, simd_level::avx512 })
+		{
+			if (!cpu_features::current().supports(level))
+				continue;
+			const auto& kernels = details::image_kernels_for(level);
+
+			for (const auto& row : rows)
+			{
+				for (std::size_t count : { 0, 5, 8, 19, 27 })
+				{
+					std::uint32_t expected_words[27], actual_words[27];
+					scalar.nearest32(words.data(), width, height, row, 7u, expected_words, count);
+					kernels.nearest32(words.data(), width, height, row, 7u, actual_words, count);
+					assert(std::equal(expected_words, expected_words + count, actual_words));
+
+					float expected[27], actual[27];
+					scalar.bilinear_float(floats.data(), width, height, row, -1.0f, expected, count);
+					kernels.bilinear_float(floats.data(), width, height, row, -1.0f, actual, count);
+					for (std::size_t i = 0; i < count; i++)
+						assert(std::fabs(expected[i] - actual[i]) <= 1e-4f);
+
+					std::uint8_t expected_bytes[27 * 4], actual_bytes[27 * 4];
+					scalar.bilinear_rgba8(bytes.data(), width, height, row, border, expected_bytes, count);
+					kernels.bilinear_rgba8(bytes.data(), width, height, row, border, actual_bytes, count);
+					for (std::size_t i = 0; i < count * 4; i++)
+						assert(std::abs(int(expected_bytes[i]) - int(actual_bytes[i])) <= 1);
+				}
+			}
+		}
+
+		// Sources whose texel indices overflow the 32-bit gathers fall back to scalar
+		assert(&details::image(65536, 32768) == &details::image());
+		assert(&details::image(65536, 32769) == &scalar);
+		assert(&details::image(4294967295u, 2) == &scalar);
+	}
+
+	// ----------------------------------------------------
+	// Affine warp
+	// ----------------------------------------------------
+
+	{
+		const size2u size(6, 5);
+		std::vector<float> source(size.width() * size.height());
+		for (std::size_t i = 0; i < source.size(); i++)
+			source[i] = static_cast<float>(i);
+		std::vector<float> destination(source.size());
+
+		// Identity reproduces the image with either filter
+		for (auto mode : { sampling::nearest, sampling::bilinear })
+		{
+			warp_affine(source.data(), size, destination.data(), size, matrix3f::identity(), mode);
+			assert(destination == source);
+		}
+
+		// Whole-pixel translation shifts the image and fills the uncovered pixels
+		warp_affine(source.data(), size, destination.data(), size, matrix3f::translate({ 2.0f, 1.0f }), sampling::bilinear, -1.0f);
+		for (unsigned y = 0; y < size.height(); y++)
+		{
+			for (unsigned x = 0; x < size.width(); x++)
+			{
+				float expected = x >= 2 && y >= 1 ? source[(y - 1) * size.width() + x - 2] : -1.0f;
+				assert(destination[y * size.width() + x] == expected);
+			}
+		}
+
+		// Magnification with nearest sampling repeats every texel
+		const size2u large(12, 10);
+		std::vector<float> magnified(large.width() * large.height());
+		warp_affine(source.data(), size, magnified.data(), large, matrix3f::scale({ 2.0f, 2.0f }), sampling::nearest);
+		for (unsigned y = 0; y < large.height(); y++)
+		{
+			for (unsigned x = 0; x < large.width(); x++)
+				assert(magnified[y * large.width() + x] == source[(y / 2) * size.width() + x / 2]);
+		}
+
+		// Half-pixel shift averages neighbours
+		warp_affine(source.data(), size, destination.data(), size, matrix3f::translate({ 0.5f, 0.0f }), sampling::bilinear);
+		assert(destination[1] == 0.5f);
+		assert(destination[size.width() + 3] == (source[size.width() + 2] + source[size.width() + 3]) / 2.0f);
+
+		// Only the clip rectangle is written
+		std::fill(destination.begin(), destination.end(), 100.0f);
+		warp_affine(source.data(), size, destination.data(), size, matrix3f::identity(), rectangleu(1, 2, 3, 10), sampling::nearest);
+		for (unsigned y = 0; y < size.height(); y++)
+		{
+			for (unsigned x = 0; x < size.width(); x++)
+			{
+				bool inside = y >= 1 && y < 3 && x >= 2;
+				assert(destination[y * size.width() + x] == (inside ? source[y * size.width() + x] : 100.0f));
+			}
+		}
+
+		bool thrown = false;
+		try
+		{
+			warp_affine(source.data(), size, destination.data(), size, matrix3f(1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.1f, 0.0f, 1.0f));
+		}
+		catch (const std::invalid_argument&)
+		{
+			thrown = true;
+		}
+		assert(thrown);
+	}
+
+	// A quarter turn moves texel (x, y) to (y, 3 - x) in a 4x4 image
+	{
+		const size2u size(4, 4);
+		std::vector<color_rgba> source(16), destination(16);
+		for (unsigned i = 0; i < 16; i++)
+			source[i] = rgba8(i, i * 2, i * 3, 255);
+
+		matrix3f transform = matrix3f::translate({ 0.0f, 4.0f }) * matrix3f::rotate(radiansf::pi() / 2.0f);
+		for (auto mode : { sampling::nearest, sampling::bilinear })
+		{
+			warp_affine(source.data(), size, destination.data(), size, transform, mode, rgba8(0, 0, 0, 0));
+			for (unsigned y = 0; y < 4; y++)
+			{
+				for (unsigned x = 0; x < 4; x++)
+					assert(destination[(3 - x) * 4 + y] == source[y * 4 + x]);
+			}
+		}
+	}
+
+	// Tiled rows give the same image as a single pass
+	{
+		const size2u size(301, 203);
+		std::vector<color_rgba> source(size.width() * size.height());
+		for (std::size_t i = 0; i < source.size(); i++)
+			source[i] = rgba8(int(i), int(i >> 2), int(i >> 5), int(i * 3));
+
+		matrix3f transform = matrix3f::translate({ 150.0f, 100.0f }) * matrix3f::rotate(radiansf(0.3f)) * matrix3f::scale({ 1.3f, 0.8f }) * matrix3f::translate({ -150.0f, -100.0f });
+		std::vector<color_rgba> single(source.size()), tiled(source.size());
+		warp_affine(source.data(), size, single.data(), size, transform);
+
+		tiling options;
+		options.threads = 3;
+		options.tile_size = 1000;
+		warp_affine(source.data(), size, tiled.data(), size, transform, sampling::bilinear, color_rgba(), options);
+		assert(single == tiled);
+	}
+
+	// ----------------------------------------------------
+	// Rasterization
+	// ----------------------------------------------------
+
+	// Every kernel level the CPU supports agrees with the scalar one
+	{
+		const auto& scalar = details::image_kernels_for(simd_level::scalar);
+		std::int32_t origins[][3] = { { 0, 0, 0 }, { -100, 50, 7 }, { 1000, -1, -900 }, { -5000, -5000, 20000 } };
+		std::int32_t steps_x[][3] = { { 16, -16, 0 }, { 32, 0, -48 }, { -160, 16, 64 }, { 1024, 2048, -4096 } };
+		std::int32_t steps_y[][3] = { { 0, 16, -16 }, { -16, 48, 16 }, { 96, 0, -32 }, { 512, -256, 128 } };
+		for (auto level : { simd_level::sse2, simd_level::avx2, simd_level::avx512 })
+		{
+			if (!cpu_features::current().supports(level))
+				continue;
+			const auto& kernels = details::image_kernels_for(level);
+			for (std::size_t i = 0; i < 4; i++)
+				assert(scalar.edge_block(origins[i], steps_x[i], steps_y[i]) == kernels.edge_block(origins[i], steps_x[i], steps_y[i]));
+		}
+	}
+
+	// Two triangles sharing a diagonal cover a rectangle exactly once
+	{
+		const int width = 40, height = 30;
+		const rectanglei screen(0, 0, height, width);
+		std::vector<int> counts(width * height);
+		auto add = [&](const coverage_block& block) { accumulate(counts, width, block); };
+
+		point2i top_left = subpixel(3, 2), top_right = subpixel(29, 2), bottom_left = subpixel(3, 21), bottom_right = subpixel(29, 21);
+		rasterize_triangle(top_left, top_right, bottom_right, screen, add);
+		rasterize_triangle(top_left, bottom_left, bottom_right, screen, add);
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+				assert(counts[y * width + x] == (x >= 3 && x < 29 && y >= 2 && y < 21 ? 1 : 0));
+		}
+
+		// Same pixels as the rectangle itself, for integral and fractional bounds
+		std::vector<int> rectangle_counts(width * height);
+		rasterize_rectangle(rectanglei(2, 3, 21, 29), screen, [&](const coverage_block& block) { accumulate(rectangle_counts, width, block); });
+		assert(rectangle_counts == counts);
+		std::fill(rectangle_counts.begin(), rectangle_counts.end(), 0);
+		rasterize_rectangle(rectanglef(1.6f, 2.6f, 20.6f, 28.9f), screen, [&](const coverage_block& block) { accumulate(rectangle_counts, width, block); });
+		assert(rectangle_counts == counts);
+	}
+
+	// A fan around a fractional center leaves no gaps or overlaps, and clipping only drops pixels
+	{
+		const int width = 64, height = 48;
+		std::vector<int> counts(width * height), clipped(width * height);
+		point2f center(31.3f, 22.7f);
+		point2i hub = to_subpixel(center);
+		const int spokes = 9;
+		point2i rim[spokes];
+		for (int i = 0; i < spokes; i++)
+		{
+			float angle = 2.0f * radiansf::pi() * i / spokes;
+			rim[i] = to_subpixel(point2f(center.x() + 20.0f * std::cos(angle), center.y() + 20.0f * std::sin(angle)));
+		}
+
+		rectanglei clip(5, 20, 40, 50);
+		for (int i = 0; i < spokes; i++)
+		{
+			rasterize_triangle(hub, rim[i], rim[(i + 1) % spokes], rectanglei(0, 0, height, width), [&](const coverage_block& block) { accumulate(counts, width, block); });
+			rasterize_triangle(hub, rim[(i + 1) % spokes], rim[i], clip, [&](const coverage_block& block)
+			{
+				assert(block.left % 8 == 0 && block.top % 8 == 0);
+				accumulate(clipped, width, block);
+			});
+		}
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				int count = counts[y * width + x];
+				assert(count <= 1);
+				float dx = x + 0.5f - center.x(), dy = y + 0.5f - center.y();
+				if (dx * dx + dy * dy < 18.0f * 18.0f)
+					assert(count == 1);
+				if (dx * dx + dy * dy > 20.5f * 20.5f)
+					assert(count == 0);
+				bool inside = x >= 20 && x < 50 && y >= 5 && y < 40;
+				assert(clipped[y * width + x] == (inside ? count : 0));
+			}
+		}
+	}
+
+	// Bins hold each primitive's blocks in the tile they fall in
+	{
+		coverage_bins bins(size2u(100, 70), 32);
+		assert(bins.columns() == 4 && bins.rows() == 3);
+		bins.add_triangle(subpixel(-10, -10), subpixel(120, 5), subpixel(40, 90), 0);
+		bins.add_rectangle(rectanglei(30, 60, 50, 70), 1);
+
+		std::vector<int> counts(100 * 70);
+		std::size_t rectangle_pixels = 0;
+		for (unsigned row = 0; row < bins.rows(); row++)
+		{
+			for (unsigned column = 0; column < bins.columns(); column++)
+			{
+				for (const auto& entry : bins.bin(column, row))
+				{
+					assert(unsigned(entry.coverage.left) / 32 == column && unsigned(entry.coverage.top) / 32 == row);
+					if (entry.primitive == 0)
+						accumulate(counts, 100, entry.coverage);
+					else
+					{
+						for (int bit = 0; bit < 64; bit++)
+							rectangle_pixels += entry.coverage.mask >> bit & 1;
+					}
+				}
+			}
+		}
+		assert(rectangle_pixels == 20 * 10);
+
+		std::vector<int> direct(100 * 70);
+		rasterize_triangle(subpixel(-10, -10), subpixel(120, 5), subpixel(40, 90), rectanglei(0, 0, 70, 100), [&](const coverage_block& block) { accumulate(direct, 100, block); });
+		assert(direct == counts);
+
+		bins.clear();
+		assert(bins.bin(0, 0).empty());
+
+		// Inverted rectangles and ones that cover no pixel center emit nothing
+		std::size_t emitted = 0;
+		auto count = [&](const coverage_block&) { emitted++; };
+		rasterize_rectangle(rectanglef(2.2f, 2.2f, 2.4f, 2.4f), rectanglei(0, 0, 70, 100), count);
+		rasterize_rectangle(rectanglei(5, 5, 3, 3), rectanglei(0, 0, 70, 100), count);
+		rasterize_rectangle(rectanglei(5, 5, 5, 9), rectanglei(0, 0, 70, 100), count);
+		assert(emitted == 0);
+		bins.add_rectangle(rectanglef(2.2f, 2.2f, 2.4f, 2.4f), 2);
+		bins.add_rectangle(rectanglei(5, 5, 3, 3), 3);
+		assert(bins.bin(0, 0).empty());
+
+		bool thrown = false;
+		try
+		{
+			coverage_bins invalid(size2u(10, 10), 12);
+		}
+		catch (const std::invalid_argument&)
+		{
+			thrown = true;
+		}
+		assert(thrown);
+	}
+
+	std::cout << "All tests completed successfully.\n";
+
+	return 0;
+}
@@ -0,0 +1,357 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cstdio>
+
+#include <cassert>
+
+#include <accel/io>
+
+using namespace accel;
+
+struct vertex
+{
+	vector3f position;
+	vector3f normal;
+};
+
+template<typename Exception, typename Function>
+static bool throws(Function function)
+{
+	try
+	{
+		function();
+	}
+	catch (const Exception&)
+	{
+		return true;
+	}
+	return false;
+}
+
+static void write_bytes(const char* path, const std::vector<char>& bytes)
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+static std::vector<char> read_bytes(const char* path)
+{
+	std::ifstream file(path, std::ios::binary);
+	return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+int main(int argc, char* argv[])
+{
+	const char* path = "io_tests.bin";
+
+	// ----------------------------------------------------
+	// Binary containers
+	// ----------------------------------------------------
+
+	// Streams round trip and are mapped in place on aligned boundaries
+	{
+		std::mt19937 random(3);
+		std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+
+		std::vector<point3f> points(1001);
+		std::vector<float> xs(points.size()), ys(points.size()), zs(points.size());
+		for (std::size_t i = 0; i < points.size(); i++)
+		{
+			points[i] = point3f(distribution(random), distribution(random), distribution(random));
+			xs[i] = points[i].x();
+			ys[i] = points[i].y();
+			zs[i] = points[i].z();
+		}
+		std::vector<matrix4f> transforms;
+		for (std::size_t i = 0; i < 7; i++)
+			transforms.push_back(matrix4f::translate({ float(i), 2.0f, 3.0f }) * matrix4f::rotate_z(degreesf(10.0f * float(i))));
+		std::vector<vertex> vertices(33);
+		for (std::size_t i = 0; i < vertices.size(); i++)
+			vertices[i].normal = vector3f(float(i), -float(i), 0.5f);
+		std::vector<std::uint16_t> indices = { 0, 1, 2, 2, 1, 3 };
+
+		binary_writer writer;
+		writer.add("positions", points.data(), points.size());
+		writer.add("transforms", transforms.data(), transforms.size());
+		writer.add("x", xs.data(), xs.size());
+		writer.add("y", ys.data(), ys.size());
+		writer.add("z", zs.data(), zs.size());
+		writer.add("normals", make_stream(vertices.data(), vertices.size(), &vertex::normal));
+		writer.add("indices", indices.data(), indices.size());
+		writer.add("empty", static_cast<const double*>(nullptr), 0);
+		assert(throws<std::invalid_argument>([&] { writer.add("x", xs.data(), xs.size()); }));
+		assert(throws<std::invalid_argument>([&] { writer.add("a name that is longer than 31 bytes", xs.data(), xs.size()); }));
+		writer.write(path);
+
+		binary_file file(path);
+		assert(file.streams().size() == 8);
+		assert(file.streams()[1].name == "transforms" && file.streams()[1].type == scalar_type::float32);
+		assert(file.streams()[1].rows == 4 && file.streams()[1].columns == 4 && file.streams()[1].element_size() == 64);
+		for (const stream_info& info : file.streams())
+			assert(info.offset % 64 == 0);
+
+		attribute_stream<const point3f> positions = file.stream<point3f>("positions");
+		assert(positions.size() == points.size());
+		assert(reinterpret_cast<std::uintptr_t>(positions.data()) % 64 == 0);
+		for (std::size_t i = 0; i < points.size(); i++)
+			assert(positions[i] == points[i]);
+
+		attribute_stream<const matrix4f> matrices = file.stream<matrix4f>("transforms");
+		assert(matrices.size() == transforms.size());
+		for (std::size_t i = 0; i < transforms.size(); i++)
+			assert(matrices[i] == transforms[i]);
+
+		// The same coordinates read as separate arrays or as strided components of the points
+		attribute_stream<const float> x = file.stream<float>("x"), y = file.component<float>("positions", 1);
+		assert(x.stride() == sizeof(float) && y.stride() == sizeof(point3f));
+		for (std::size_t i = 0; i < points.size(); i++)
+			assert(x[i] == points[i].x() && y[i] == points[i].y() && file.stream<float>("z")[i] == points[i].z());
+
+		attribute_stream<const vector3f> normals = file.stream<vector3f>("normals");
+		for (std::size_t i = 0; i < vertices.size(); i++)
+			assert(normals[i] == vertices[i].normal);
+		attribute_stream<const std::uint16_t> read_indices = file.stream<std::uint16_t>("indices");
+		assert((std::vector<std::uint16_t>(read_indices.begin(), read_indices.end()) == indices));
+		assert(file.stream<double>("empty").empty());
+
+		assert(file.find("missing") == nullptr && file.find("x") != nullptr);
+		assert(throws<std::invalid_argument>([&] { file.stream<point3f>("missing"); }));
+		assert(throws<std::invalid_argument>([&] { file.stream<vector4f>("positions"); }));
+		assert(throws<std::invalid_argument>([&] { file.stream<point<3, double>>("positions"); }));
+		assert(throws<std::invalid_argument>([&] { file.component<float>("positions", 3); }));
+
+		binary_file moved = std::move(file);
+		assert(moved.stream<point3f>("positions")[5] == points[5]);
+	}
+
+	// Shapes that do not fit the 16-bit row and column fields are refused
+	{
+		unsigned char record[64];
+		stream_info wide = details::describe<float>("wide", 1);
+		wide.columns = 70000;
+		assert(throws<std::invalid_argument>([&] { details::encode_record(record, wide); }));
+	}
+
+	// A container without streams is valid
+	{
+		binary_writer().write(path);
+		binary_file file(path);
+		assert(file.streams().empty());
+	}
+
+	// Damaged or foreign files are rejected before any stream is exposed
+	{
+		std::vector<point3f> points(100, point3f(1.0f, 2.0f, 3.0f));
+		binary_writer writer;
+		writer.add("positions", points.data(), points.size());
+		writer.write(path);
+		const std::vector<char> valid = read_bytes(path);
+
+		std::vector<char> truncated(valid.begin(), valid.end() - 1);
+		write_bytes(path, truncated);
+		assert(throws<std::runtime_error>([&] { binary_file file(path); }));
+
+		std::vector<char> foreign = valid;
+		foreign[0] = 'X';
+		write_bytes(path, foreign);
+		assert(throws<std::runtime_error>([&] { binary_file file(path); }));
+
+		std::vector<char> newer = valid;
+		newer[8] = 2;
+		write_bytes(path, newer);
+		assert(throws<std::runtime_error>([&] { binary_file file(path); }));
+
+		// A count that runs past the end of the file
+		std::vector<char> overlong = valid;
+		overlong[64 + 40 + 7] = 1;
+		write_bytes(path, overlong);
+		assert(throws<std::runtime_error>([&] { binary_file file(path); }));
+
+		// A stream placed over the header or over the stream table
+		for (unsigned char offset : { 0, 64 })
+		{
+			std::vector<char> overlapping = valid;
+			for (int i = 0; i < 8; i++)
+				overlapping[64 + 48 + i] = i == 0 ? static_cast<char>(offset) : 0;
+			write_bytes(path, overlapping);
+			assert(throws<std::runtime_error>([&] { binary_file file(path); }));
+			assert(throws<std::runtime_error>([&] { block_reader<point3f> reader(path, "positions"); }));
+		}
+
+		write_bytes(path, std::vector<char>());
+		assert(throws<std::runtime_error>([&] { binary_file file(path); }));
+
+		std::remove(path);
+		assert(throws<std::runtime_error>([&] { binary_file file(path); }));
+	}
+
+	// ----------------------------------------------------
+	// Streaming
+	// ----------------------------------------------------
+
+	// Block readers return a stream in order in blocks of at most the block size
+	{
+		std::vector<point3f> points(1000);
+		for (std::size_t i = 0; i < points.size(); i++)
+			points[i] = point3f(float(i), float(i) * 2.0f, -float(i));
+		std::vector<float> weights(10, 0.5f);
+		binary_writer writer;
+		writer.add("weights", weights.data(), weights.size());
+		writer.add("positions", points.data(), points.size());
+		writer.add("empty", static_cast<const point3f*>(nullptr), 0);
+		writer.write(path);
+
+		for (std::size_t block_size : { std::size_t(1), std::size_t(64), std::size_t(999), std::size_t(1000), std::size_t(5000) })
+		{
+			block_reader<point3f> reader(path, "positions", block_size);
+			assert(reader.info().count == points.size());
+			std::vector<point3f> read;
+			for (attribute_stream<point3f> block = reader.next(); !block.empty(); block = reader.next())
+			{
+				assert(block.size() == std::min(block_size, points.size() - read.size()));
+				read.insert(read.end(), block.begin(), block.end());
+			}
+			assert(read == points);
+			assert(reader.next().empty());
+		}
+
+		block_reader<point3f> empty(path, "empty");
+		assert(empty.next().empty());
+
+		// Abandoning a reader mid-stream waits for the read in flight
+		{
+			block_reader<point3f> reader(path, "positions", 10);
+			assert(reader.next()[3] == points[3]);
+		}
+
+		// A failed read keeps failing instead of passing for the end of the stream
+		{
+			block_reader<point3f> reader(path, "positions", 10);
+			std::vector<char> bytes = read_bytes(path);
+			bytes.resize(bytes.size() / 2);
+			write_bytes(path, bytes);
+			bool failed = false;
+			for (std::size_t i = 0; i < 100 && !failed; i++)
+				failed = throws<std::runtime_error>([&] { reader.next(); });
+			assert(failed);
+			assert(throws<std::runtime_error>([&] { reader.next(); }));
+			assert(throws<std::runtime_error>([&] { reader.next(); }));
+		}
+		writer.write(path);
+
+		assert(throws<std::invalid_argument>([&] { block_reader<point3f> reader(path, "missing"); }));
+		assert(throws<std::invalid_argument>([&] { block_reader<point3f> reader(path, "weights"); }));
+		std::remove(path);
+		assert(throws<std::runtime_error>([&] { block_reader<point3f> reader(path, "positions"); }));
+	}
+
+	// Block writers append contiguous and strided blocks into a valid container
+	{
+		std::vector<vertex> vertices(100);
+		for (std::size_t i = 0; i < vertices.size(); i++)
+			vertices[i].position = vector3f(float(i), 1.0f, 2.0f);
+		{
+			block_writer<vector3f> writer(path, "positions");
+			writer.write(make_stream(vertices.data(), 60, &vertex::position));
+			std::vector<vector3f> rest;
+			for (std::size_t i = 60; i < vertices.size(); i++)
+				rest.push_back(vertices[i].position);
+			writer.write(attribute_stream<vector3f>(rest.data(), rest.size()));
+			assert(writer.size() == vertices.size());
+			writer.close();
+		}
+
+		binary_file file(path);
+		attribute_stream<const vector3f> positions = file.stream<vector3f>("positions");
+		assert(positions.size() == vertices.size());
+		for (std::size_t i = 0; i < vertices.size(); i++)
+			assert(positions[i] == vertices[i].position);
+
+		assert(throws<std::invalid_argument>([&] { block_writer<vector3f> writer(path, ""); }));
+
+		// A writer destroyed without close, as when an exception unwinds it, leaves a file that is rejected
+		for (std::size_t count : { std::size_t(0), std::size_t(40) })
+		{
+			{
+				block_writer<vector3f> writer(path, "positions");
+				writer.write(make_stream(vertices.data(), count, &vertex::position));
+			}
+			assert(throws<std::runtime_error>([&] { binary_file abandoned(path); }));
+		}
+		std::remove(path);
+	}
+
+	// Transforming and cropping out of core matches the same steps in memory
+	{
+		std::mt19937 random(11);
+		std::uniform_real_distribution<float> distribution(-50.0f, 50.0f);
+		std::vector<point3f> points(10007);
+		for (point3f& p : points)
+			p = point3f(distribution(random), distribution(random), distribution(random));
+		binary_writer writer;
+		writer.add("points", points.data(), points.size());
+		writer.write(path);
+
+		matrix4f m = matrix4f::translate({ 10.0f, 0.0f, -5.0f }) * matrix4f::rotate_z(degreesf(30.0f));
+		point3f minimum(-20.0f, -30.0f, -40.0f), maximum(30.0f, 20.0f, 10.0f);
+		const char* output = "io_tests_cropped.bin";
+		point_statistics<float> statistics = transform_and_crop(path, output, "points", m, minimum, maximum, 512);
+
+		// Blocks are a multiple of the kernel width, so every point takes the same kernel path as here
+		std::vector<point3f> expected = points;
+		transform_points(m, attribute_stream<point3f>(expected.data(), expected.size()));
+		expected.erase(std::remove_if(expected.begin(), expected.end(), [&](const point3f& p)
+		{
+			return p.x() < minimum.x() || p.x() > maximum.x() || p.y() < minimum.y() || p.y() > maximum.y() || p.z() < minimum.z() || p.z() > maximum.z();
+		}), expected.end());
+		assert(!expected.empty() && expected.size() < points.size());
+
+		{
+			binary_file file(output);
+			attribute_stream<const point3f> cropped = file.stream<point3f>("points");
+			assert((std::vector<point3f>(cropped.begin(), cropped.end()) == expected));
+		}
+
+		assert(statistics.read == points.size() && statistics.written == expected.size());
+		for (std::size_t k = 0; k < 3; k++)
+		{
+			double mean = 0.0, variance = 0.0;
+			float lower = expected[0][k], upper = lower;
+			for (const point3f& p : expected)
+			{
+				mean += p[k];
+				lower = std::min(lower, p[k]);
+				upper = std::max(upper, p[k]);
+			}
+			mean /= double(expected.size());
+			for (const point3f& p : expected)
+				variance += (p[k] - mean) * (p[k] - mean);
+			variance /= double(expected.size());
+
+			assert(statistics.minimum[k] == lower && statistics.maximum[k] == upper);
+			assert(std::fabs(statistics.mean[k] - mean) <= 1e-4);
+			assert(std::fabs(statistics.variance[k] - variance) <= variance * 1e-5);
+		}
+
+		// A box that excludes everything writes an empty stream
+		std::vector<point<3, double>> doubles;
+		for (const point3f& p : points)
+			doubles.push_back(point<3, double>(p.x(), p.y(), p.z()));
+		binary_writer double_writer;
+		double_writer.add("points", doubles.data(), doubles.size());
+		double_writer.write(path);
+		point_statistics<double> nothing = transform_and_crop(path, output, "points", matrix<4, 4, double>::translate({ 1e3, 0.0, 0.0 }), point<3, double>(1e4, 0.0, 0.0), point<3, double>(2e4, 1.0, 1.0));
+		assert(nothing.read == points.size() && nothing.written == 0);
+		assert(nothing.minimum.x() > nothing.maximum.x());
+		assert((binary_file(output).stream<point<3, double>>("points").empty()));
+		(void)nothing;
+
+		std::remove(path);
+		std::remove(output);
+	}
+
+	std::cout << "All tests completed successfully.\n";
+
+	return 0;
+}
@@ -1,5 +1,7 @@
 #include <iostream>
 #include <type_traits>
+#include <random>
+#include <vector>
 
 #include <cassert>
 
@@ -7,6 +9,25 @@
 
 using namespace accel;
 
+static bool near(const matrix4f& a, const matrix4f& b)
+{
+	for (std::size_t i = 0; i < matrix4f::size(); i++)
+	{
+		if (std::fabs(a(i) - b(i)) > 1e-4f)
+			return false;
+	}
+	return true;
+}
+
+// An interleaved vertex with a 36 byte stride
+struct vertex
+{
+	vector3f position;
+	vector3f normal;
+	vector2f uv;
+	std::uint8_t color[4];
+};
+
 int main(int argc, char* argv[])
 {
 	// ----------------------------------------------------
@@ -105,6 +126,70 @@ int main(int argc, char* argv[])
 		vector2f v1(1.0f, 0.0f);
 		vector2f v2(0.0f, 1.0f);
 		assert(v1.angle(v2) == degreesf(90.0f));
+
+		vector3f v3(3.0f, -4.0f, 12.0f);
+		assert(std::fabs(v3.fast_length() - 13.0f) <= 13.0f * 1e-5f);
+		assert(std::fabs(v3.fast_normalized().length() - 1.0f) <= 1e-5f);
+		assert(vector3f().fast_length() == 0.0f);
+		assert(vector3f().fast_normalized() == vector3f());
+		assert(details::fast_rsqrt(std::numeric_limits<float>::infinity()) == 0.0f);
+		assert(details::fast_rsqrt(std::numeric_limits<double>::infinity()) == 0.0);
+	}
+
+	// Distances and cosine
+	{
+		vector3f v1(1.0f, 2.0f, 2.0f);
+		vector3f v2(1.0f, 2.0f, 2.0f + 4.0f);
+		assert(v1.distance_squared(v2) == 16.0f);
+		assert(v1.distance(v2) == 4.0f);
+		assert(v1.cosine(v1) == 1.0f);
+		assert(vector2f(1.0f, 0.0f).cosine(vector2f(0.0f, -3.0f)) == 0.0f);
+		assert(v1.cosine(vector3f()) == 0.0f);
+	}
+
+	// Large vectors loop instead of expanding, and agree with a double-precision reference
+	{
+		std::mt19937 random(7);
+		std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+		vector<517, float> a, b;
+		vector<40, double> c, d;
+		for (std::size_t i = 0; i < a.size(); i++)
+		{
+			a[i] = coordinate(random);
+			b[i] = coordinate(random);
+		}
+		for (std::size_t i = 0; i < c.size(); i++)
+		{
+			c[i] = coordinate(random);
+			d[i] = coordinate(random);
+		}
+		assert((vector<517, float>()[516] == 0.0f));
+
+		double dot = 0.0, distance = 0.0, length = 0.0;
+		for (std::size_t i = 0; i < a.size(); i++)
+		{
+			dot += double(a[i]) * b[i];
+			distance += (double(a[i]) - b[i]) * (double(a[i]) - b[i]);
+			length += double(a[i]) * a[i];
+		}
+		assert(std::fabs(a * b - dot) <= 1e-4);
+		assert(std::fabs(a.distance_squared(b) - distance) <= 1e-3);
+		assert(std::fabs(a.length() - std::sqrt(length)) <= 1e-4);
+		assert(std::fabs(a.normalized().length() - 1.0f) <= 1e-5f);
+		assert(std::fabs(a.cosine(b) - dot / std::sqrt(length * (b * b))) <= 1e-5);
+
+		auto sum = a + b, difference = a - b, scaled = a * 2.0f, shifted = a - 1.0f;
+		for (std::size_t i = 0; i < a.size(); i++)
+		{
+			assert(sum[i] == a[i] + b[i] && difference[i] == a[i] - b[i]);
+			assert(scaled[i] == a[i] * 2.0f && shifted[i] == a[i] - 1.0f);
+		}
+
+		double expected = 0.0;
+		for (std::size_t i = 0; i < c.size(); i++)
+			expected += c[i] * d[i];
+		assert(std::fabs(c * d - expected) <= 1e-12);
+		assert(std::fabs((c + d - d).distance(c)) <= 1e-12);
 	}
 
 	// Swizzle
@@ -139,6 +224,25 @@ int main(int argc, char* argv[])
 			assert((v * m) == vector3f(14.0f, 32.0f, 50.0f));
 		}
 
+		{
+			vector3f x(1.0f, 0.0f, 0.0f);
+			vector3f y(0.0f, 1.0f, 0.0f);
+			assert((x ^ y) == vector3f(0.0f, 0.0f, 1.0f));
+			assert((y ^ x) == vector3f(0.0f, 0.0f, -1.0f));
+		}
+
+		// Products rounded only once wherever the CPU has FMA, so these cancellations are exact
+		if (details::fused_arithmetic())
+		{
+			const float e = 1.0f / 8192.0f;
+			assert((vector2f(1.0f + e, 1.0f) ^ vector2f(1.0f, 1.0f - e)) == -e * e);
+			assert((vector2f(1.0f, 1.0f + e) * vector2f(-1.0f, 1.0f - e)) == -e * e);
+			assert((matrix2f(1.0f, 1.0f + e, 1.0f + e, 0.0f) * vector2f(-1.0f, 1.0f - e))[0] == -e * e);
+
+			const double d = 1.0 / (1 << 27);
+			assert((vector3d(0.0, 1.0 + d, 1.0) ^ vector3d(0.0, 1.0, 1.0 - d)) == vector3d(-d * d, 0.0, 0.0));
+		}
+
 		{
 			matrix4f m = matrix4f::translate({-16.0f, -16.0f, 0.0f});
 			vector4f v(0.0f, 32.0f, 0.0f, 1.0f);
@@ -264,6 +368,54 @@ int main(int argc, char* argv[])
 				-5.0f, 4.0f, 1.0f
 			));
 		}
+
+		// Larger determinants go through elimination instead of cofactor expansion
+		{
+			matrix<5, 5, float> a(
+				2.0f, -1.0f, 0.0f, 3.0f, 1.0f,
+				4.0f, 1.0f, -2.0f, 0.0f, 5.0f,
+				0.0f, 3.0f, 1.0f, -1.0f, 2.0f,
+				1.0f, 0.0f, 4.0f, 2.0f, -3.0f,
+				-2.0f, 5.0f, 1.0f, 0.0f, 1.0f
+			);
+			assert(std::fabs(a.determinant() - 305.0f) <= 1e-3f);
+
+			matrix<5, 5, int> b(
+				2, -1, 0, 3, 1,
+				4, 1, -2, 0, 5,
+				0, 3, 1, -1, 2,
+				1, 0, 4, 2, -3,
+				-2, 5, 1, 0, 1
+			);
+			assert(b.determinant() == 305);
+
+			// Zero leading pivots need a row swap, which flips the sign
+			matrix<6, 6, int> permutation;
+			matrix<6, 6, double> triangular;
+			for (std::size_t i = 0; i < 6; i++)
+			{
+				permutation((i + 1) % 6, i) = 1;
+				for (std::size_t j = i; j < 6; j++)
+					triangular(i, j) = double(i + j + 1);
+			}
+			assert(permutation.determinant() == -1);
+			assert(triangular.determinant() == 1.0 * 3.0 * 5.0 * 7.0 * 9.0 * 11.0);
+
+			matrix<8, 8, int> singular;
+			for (std::size_t i = 0; i < 8; i++)
+			{
+				for (std::size_t j = 0; j < 8; j++)
+					singular(i, j) = int((i * 7 + j * 3) % 11) - 5;
+			}
+			assert(singular.determinant() == 0);
+
+			auto identity = a * a.inverse();
+			for (std::size_t i = 0; i < 5; i++)
+			{
+				for (std::size_t j = 0; j < 5; j++)
+					assert(std::fabs(identity(i, j) - (i == j ? 1.0f : 0.0f)) <= 1e-5f);
+			}
+		}
 	}
 
 	// Multiplication
@@ -302,6 +454,609 @@ int main(int argc, char* argv[])
 		}
 	}
 
+	// Structured matrices agree with their dense equivalents
+	{
+		{
+			diagonal_matrix<3> d(vector3f(2.0f, 4.0f, 8.0f));
+			matrix3f m(
+				1.0f, 2.0f, 3.0f,
+				4.0f, 5.0f, 6.0f,
+				7.0f, 8.0f, 9.0f
+			);
+			const matrix3f& dense = d;
+			assert(d * m == dense * m);
+			assert(m * d == m * dense);
+			assert((d * d).diagonal() == vector3f(4.0f, 16.0f, 64.0f));
+			assert(d * vector3f(1.0f, 1.0f, 1.0f) == vector3f(2.0f, 4.0f, 8.0f));
+			assert(d.inverse().diagonal() == vector3f(0.5f, 0.25f, 0.125f));
+			assert(d.determinant() == 64.0f);
+			assert(diagonal_matrix<3>::identity() == matrix3f::identity());
+		}
+
+		{
+			auto r = rotation_matrix<3>::rotate_z(degreesf(30.0f)) * rotation_matrix<3>::rotate_x(degreesf(45.0f));
+			auto product = r * r.inverse();
+			for (std::size_t i = 0; i < 3; i++)
+			{
+				for (std::size_t j = 0; j < 3; j++)
+					assert(std::fabs(product(i, j) - (i == j ? 1.0f : 0.0f)) <= 1e-6f);
+			}
+			assert(rotation_matrix<3>::rotate_y(degreesf(10.0f)) == matrix4f::rotate_y(degreesf(10.0f)).cofactor(3, 3));
+		}
+
+		{
+			auto a = affine_matrix<3>::translate({ 1.0f, 2.0f, 3.0f }) * affine_matrix<3>::rotate_x(degreesf(30.0f));
+			auto b = affine_matrix<3>::scale({ 2.0f, 3.0f, 4.0f }) * affine_matrix<3>::rotate_z(degreesf(60.0f)) * affine_matrix<3>::translate({ -5.0f, 0.5f, 7.0f });
+			matrix4f dense_a = matrix4f::translate({ 1.0f, 2.0f, 3.0f }) * matrix4f::rotate_x(degreesf(30.0f));
+			matrix4f dense_b = matrix4f::scale({ 2.0f, 3.0f, 4.0f }) * matrix4f::rotate_z(degreesf(60.0f)) * matrix4f::translate({ -5.0f, 0.5f, 7.0f });
+
+			assert(near(a, dense_a));
+			assert(near(b, dense_b));
+			assert(near(a * b, dense_a * dense_b));
+			assert(near(a * b.inverse() * b, a));
+			assert(near(b.inverse(), dense_b.inverse()));
+
+			vector4f v(1.0f, -2.0f, 3.0f, 1.0f);
+			assert(((b * v) - (dense_b * v)).length() <= 1e-4f);
+			vector3f p = b.transform_point(point3f(1.0f, -2.0f, 3.0f));
+			assert((p - (dense_b * v).swizzle<swizzle_x, swizzle_y, swizzle_z>()).length() <= 1e-4f);
+			assert((b.transform_vector(vector3f(1.0f, -2.0f, 3.0f)) - (dense_b * vector4f(1.0f, -2.0f, 3.0f, 0.0f)).swizzle<swizzle_x, swizzle_y, swizzle_z>()).length() <= 1e-4f);
+			assert(affine_matrix<3>::translate({ 1.0f, 2.0f, 3.0f }).translation() == vector3f(1.0f, 2.0f, 3.0f));
+		}
+	}
+
+	// Compact affine transform
+	{
+		static_assert(sizeof(affine3f) == 12 * sizeof(float), "affine3 must store 12 values");
+
+		matrix4f dense_a = matrix4f::translate({ 1.0f, 2.0f, 3.0f }) * matrix4f::rotate_x(degreesf(30.0f));
+		matrix4f dense_b = matrix4f::scale({ 2.0f, 3.0f, 4.0f }) * matrix4f::rotate_z(degreesf(60.0f)) * matrix4f::translate({ -5.0f, 0.5f, 7.0f });
+		affine3f a(dense_a);
+		affine3f b = affine3f::scale({ 2.0f, 3.0f, 4.0f }) * affine3f::rotate_z(degreesf(60.0f)) * affine3f::translate({ -5.0f, 0.5f, 7.0f });
+
+		assert(a.to_matrix() == dense_a);
+		assert(near(b.to_matrix(), dense_b));
+		assert(near((a * b).to_matrix(), dense_a * dense_b));
+		assert(near(b.inverse().to_matrix(), dense_b.inverse()));
+		assert(std::fabs(b.determinant() - dense_b.determinant()) <= 1e-3f);
+		assert(affine3f::translate({ 1.0f, 2.0f, 3.0f }).translation() == vector3f(1.0f, 2.0f, 3.0f));
+		assert(affine3f::translate({ 1.0f, 2.0f, 3.0f }).row(0) == vector4f(1.0f, 0.0f, 0.0f, 1.0f));
+
+		point3f points[2] = { point3f(1.0f, -2.0f, 3.0f), point3f(0.0f, 0.0f, 0.0f) };
+		vector3f directions[2] = { vector3f(1.0f, -2.0f, 3.0f), vector3f(0.0f, 1.0f, 0.0f) };
+		transform(b, points, points, 2);
+		transform(b, directions, directions, 2);
+		vector3f expected_point = (dense_b * vector4f(1.0f, -2.0f, 3.0f, 1.0f)).swizzle<swizzle_x, swizzle_y, swizzle_z>();
+		vector3f expected_direction = (dense_b * vector4f(1.0f, -2.0f, 3.0f, 0.0f)).swizzle<swizzle_x, swizzle_y, swizzle_z>();
+		assert((vector3f(points[0]) - expected_point).length() <= 1e-4f);
+		assert((vector3f(points[1]) - b.translation()).length() <= 1e-4f);
+		assert((directions[0] - expected_direction).length() <= 1e-4f);
+
+		affine3f locals[2] = { a, b };
+		affine3f parents[2] = { b, a };
+		affine3f worlds[2];
+		multiply(locals, parents, worlds, 2);
+		assert(worlds[0] == a * b && worlds[1] == b * a);
+
+		matrix4f dense[2];
+		convert(worlds, dense, 2);
+		convert(dense, worlds, 2);
+		assert(worlds[0] == a * b);
+	}
+
+	// Quaternions
+	{
+		quaternionf qx = quaternionf::rotate(vector3f(1.0f, 0.0f, 0.0f), degreesf(30.0f));
+		quaternionf qz = quaternionf::rotate(vector3f(0.0f, 0.0f, 2.0f), degreesf(60.0f));
+		assert(near(affine_matrix<3>(qx.to_matrix()), matrix4f::rotate_x(degreesf(30.0f))));
+		assert(near(affine_matrix<3>(qz.to_matrix()), matrix4f::rotate_z(degreesf(60.0f))));
+		assert(near(affine_matrix<3>((qx * qz).to_matrix()), matrix4f::rotate_x(degreesf(30.0f)) * matrix4f::rotate_z(degreesf(60.0f))));
+
+		quaternionf q = quaternionf::from_matrix(rotation_matrix<3>::rotate_y(degreesf(-120.0f)) * rotation_matrix<3>::rotate_x(degreesf(75.0f)));
+		assert(near(affine_matrix<3>(q.to_matrix()), matrix4f::rotate_y(degreesf(-120.0f)) * matrix4f::rotate_x(degreesf(75.0f))));
+		assert((q.transform_vector(vector3f(1.0f, 2.0f, 3.0f)) - (q.to_matrix() * vector3f(1.0f, 2.0f, 3.0f))).length() <= 1e-5f);
+		assert(std::fabs((q * q.inverse()).w() - 1.0f) <= 1e-6f);
+	}
+
+	// Dual quaternions
+	{
+		matrix4f dense_a = matrix4f::rotate_x(degreesf(30.0f)) * matrix4f::translate({ 1.0f, 2.0f, 3.0f });
+		matrix4f dense_b = matrix4f::rotate_z(degreesf(-45.0f)) * matrix4f::translate({ -4.0f, 0.5f, 2.0f });
+		dual_quaternionf a = dual_quaternionf::from_matrix(dense_a);
+		dual_quaternionf b = dual_quaternionf::from_matrix(dense_b);
+		assert(near(a.to_matrix(), dense_a));
+		assert(near((a * b).to_matrix(), dense_a * dense_b));
+		assert(near((a * a.inverse()).to_matrix(), matrix4f::identity()));
+		assert((a.translation() - vector3f(1.0f, 2.0f, 3.0f)).length() <= 1e-5f);
+
+		vector3f p = a.transform_point(point3f(1.0f, -2.0f, 0.5f));
+		assert((p - (dense_a * vector4f(1.0f, -2.0f, 0.5f, 1.0f)).swizzle<swizzle_x, swizzle_y, swizzle_z>()).length() <= 1e-5f);
+
+		// Skinning: every kernel level matches the scalar blend, and a single full-weight bone is a rigid transform
+		dual_quaternionf bones[3] = { a, b, b * -1.0f };
+		const std::size_t count = 21;
+		vector<4, unsigned char> indices[count];
+		vector4f weights[count];
+		point3f positions[count];
+		vector3f normals[count];
+		for (std::size_t i = 0; i < count; i++)
+		{
+			indices[i] = vector<4, unsigned char>((unsigned char)(i % 3), (unsigned char)((i + 1) % 3), (unsigned char)((i + 2) % 3), (unsigned char)0);
+			float w = static_cast<float>(i) / count;
+			weights[i] = i == 0 ? vector4f(1.0f, 0.0f, 0.0f, 0.0f) : vector4f(w, 1.0f - w, 0.0f, 0.0f) * 0.75f + vector4f(0.0f, 0.0f, 0.25f, 0.0f);
+			positions[i] = point3f(static_cast<float>(i), 1.0f - static_cast<float>(i), 0.5f);
+			normals[i] = vector3f(0.0f, static_cast<float>(i % 2), static_cast<float>((i + 1) % 2));
+		}
+
+		point3f expected_positions[count];
+		vector3f expected_normals[count];
+		skin<float>(bones, indices, weights, positions, normals, expected_positions, expected_normals, count);
+		assert((vector3f(expected_positions[0]) - vector3f(a.transform_point(positions[0]))).length() <= 1e-5f);
+
+		std::uint32_t flat_indices[count * 4];
+		for (std::size_t i = 0; i < count * 4; i++)
+			flat_indices[i] = indices[i / 4][i % 4];
+		for (auto level : { simd_level::scalar, simd_level::sse2, simd_level::avx2, simd_level::avx512 })
+		{
+			if (!cpu_features::current().supports(level))
+				continue;
+			point3f actual_positions[count];
+			vector3f actual_normals[count];
+			details::kernels_for(level).skin(bones[0].real().data(), flat_indices, weights[0].data(), positions[0].data(),
+				normals[0].data(), actual_positions[0].data(), actual_normals[0].data(), count);
+			for (std::size_t i = 0; i < count; i++)
+			{
+				assert((vector3f(actual_positions[i]) - vector3f(expected_positions[i])).length() <= 1e-4f);
+				assert((actual_normals[i] - expected_normals[i]).length() <= 1e-5f);
+			}
+		}
+
+		point3f dispatched[count];
+		skin(bones, indices, weights, positions, nullptr, dispatched, nullptr, count);
+		for (std::size_t i = 0; i < count; i++)
+			assert((vector3f(dispatched[i]) - vector3f(expected_positions[i])).length() <= 1e-4f);
+	}
+
+	// ----------------------------------------------------
+	// Storage types
+	// ----------------------------------------------------
+
+	// Half precision rounds to nearest even and keeps special values
+	{
+		assert(half(1.0f).bits() == 0x3c00);
+		assert(half(-2.0f).bits() == 0xc000);
+		assert(half(65504.0f).bits() == 0x7bff);
+		assert(half(1e6f).bits() == 0x7c00);
+		assert(half(-std::numeric_limits<float>::infinity()).bits() == 0xfc00);
+		assert(half(5.9604645e-8f).bits() == 0x0001);
+		assert(half(1.0f + 1.0f / 2048.0f).bits() == 0x3c00);
+		assert(half(1.0f + 3.0f / 2048.0f).bits() == 0x3c02);
+		assert(float(half::from_bits(0x3555)) == 0.33325195f);
+		assert(float(half::from_bits(0x0001)) == 5.9604645e-8f);
+		float nan = float(half(std::numeric_limits<float>::quiet_NaN()));
+		assert(nan != nan);
+		for (std::uint32_t bits = 0; bits < 0x7c00; bits++)
+			assert(half(float(half::from_bits(static_cast<std::uint16_t>(bits)))).bits() == bits);
+
+		vector3f in[3] = { vector3f(0.5f, -0.25f, 3.0f), vector3f(1024.0f, 0.1f, -7.0f), vector3f() };
+		vector3h packed[3];
+		vector3f out[3];
+		pack(in, packed, 3);
+		unpack(packed, out, 3);
+		assert(out[0] == in[0]);
+		assert(std::fabs(out[1].y() - 0.1f) <= 1e-4f);
+		assert(sizeof(packed) == 3 * 3 * sizeof(std::uint16_t));
+	}
+
+	// Normalized integers follow the unorm/snorm conversion rules
+	{
+		assert(unorm8(1.0f).bits() == 255);
+		assert(unorm8(0.5f).bits() == 128);
+		assert(unorm8(-3.0f).bits() == 0);
+		assert(unorm8(std::numeric_limits<float>::quiet_NaN()).bits() == 0);
+		assert(float(unorm8::from_bits(51)) == 0.2f);
+		assert(snorm8(-1.0f).bits() == -127);
+		assert(snorm8(2.0f).bits() == 127);
+		assert(float(snorm8::from_bits(-128)) == -1.0f);
+		assert(float(snorm16(0.0f)) == 0.0f);
+		assert(std::fabs(float(unorm16(0.3f)) - 0.3f) <= 1.0f / 65535.0f);
+
+		vector4f colors[2] = { vector4f(1.0f, 0.0f, 0.5f, 1.0f), vector4f(0.2f, 0.4f, 0.6f, 0.8f) };
+		vector<4, unorm8> packed[2];
+		vector4f out[2];
+		pack(colors, packed, 2);
+		unpack(packed, out, 2);
+		assert(packed[0][2].bits() == 128);
+		assert(out[1] == colors[1]);
+	}
+
+	// Octahedral normals round trip within the storage precision
+	{
+		vector3f normals[6] = { vector3f(0.0f, 0.0f, 1.0f), vector3f(0.0f, 0.0f, -1.0f), vector3f(1.0f, 2.0f, -3.0f).normalized(),
+			vector3f(-0.3f, 0.9f, 0.1f).normalized(), vector3f(-1.0f, -1.0f, -1.0f).normalized(), vector3f(1.0f, 0.0f, 0.0f) };
+		for (const auto& n : normals)
+			assert((octahedral_decode(octahedral_encode(n)) - n).length() <= 1e-6f);
+
+		vector<2, snorm16> packed[6];
+		vector3f out[6];
+		pack_octahedral(normals, packed, 6);
+		unpack_octahedral(packed, out, 6);
+		for (std::size_t i = 0; i < 6; i++)
+			assert((out[i] - normals[i]).length() <= 1e-4f);
+	}
+
+	// ----------------------------------------------------
+	// Views
+	// ----------------------------------------------------
+
+	// Vector views compute the same results as vectors and write through to the buffer
+	{
+		float buffer[6] = { 1.0f, 2.0f, 2.0f, 0.0f, 3.0f, 4.0f };
+		vector_view<3, float> a(buffer);
+		vector_view<3, const float> b(buffer + 3);
+		vector3f va(1.0f, 2.0f, 2.0f), vb(0.0f, 3.0f, 4.0f);
+
+		assert(a.value() == va && b.value() == vb);
+		assert(a * b == va * vb && a * vb == va * vb && va * b == va * vb);
+		assert(a.length() == 3.0f && b.length_squared() == 25.0f && a.sum() == 5.0f);
+		assert(a.normalized() == va.normalized());
+		assert((a + b) == va + vb && (a - vb) == va - vb && (va - b) == va - vb);
+		assert((a ^ b) == (va ^ vb));
+		assert(a.distance_squared(b) == va.distance_squared(vb));
+		assert(a.cosine(b) == va.cosine(vb));
+		assert(a * 2.0f == va * 2.0f);
+
+		matrix3f m(
+			1.0f, 2.0f, 3.0f,
+			4.0f, 5.0f, 6.0f,
+			7.0f, 8.0f, 9.0f
+		);
+		assert(a * m == va * m);
+		assert(m * b == m * vb);
+
+		a += b;
+		assert(buffer[0] == 1.0f && buffer[1] == 5.0f && buffer[2] == 6.0f);
+		a *= 0.5f;
+		assert(buffer[1] == 2.5f);
+		a.assign(vector3f(7.0f, 8.0f, 9.0f));
+		assert(buffer[0] == 7.0f && buffer[2] == 9.0f);
+
+		// Views are shallow: assigning one rebinds it
+		vector_view<3, float> c(buffer + 3);
+		c = a;
+		assert(c.data() == buffer);
+		vector_view<3, const float> d = a;
+		assert(d[1] == 8.0f);
+	}
+
+	// Strided views read components spread across separate arrays
+	{
+		float xs[2] = { 1.0f, 10.0f }, ys[2] = { 2.0f, 20.0f }, zs[2] = { 3.0f, 30.0f };
+		float planes[6] = { xs[0], xs[1], ys[0], ys[1], zs[0], zs[1] };
+		strided_vector_view<3, float> second(planes + 1, 2 * sizeof(float));
+		assert(second.value() == vector3f(10.0f, 20.0f, 30.0f));
+		assert(second * vector3f(1.0f, 1.0f, 1.0f) == 60.0f);
+		second -= vector3f(10.0f, 20.0f, 30.0f);
+		assert(planes[1] == 0.0f && planes[3] == 0.0f && planes[5] == 0.0f && planes[0] == 1.0f);
+	}
+
+	// Matrix views multiply like matrices and expose rows and columns
+	{
+		float buffer[16];
+		matrix4f m = matrix4f::translate({ 1.0f, 2.0f, 3.0f }) * matrix4f::rotate_z(degreesf(30.0f));
+		std::copy(m.data(), m.data() + 16, buffer);
+		matrix_view<4, 4, const float> view(buffer);
+		vector4f v(1.0f, -2.0f, 0.5f, 1.0f);
+
+		assert(view.value() == m);
+		assert(view * v == m * v);
+		assert(v * view == v * m);
+		assert(view * m == m * m && m * view == m * m && view * view == m * m);
+		assert(view.transposed() == m.transposed());
+		assert(view.determinant() == m.determinant());
+		assert(view(1, 3) == m(1, 3) && view.row(2).value() == m.row(2) && view.column(1).value() == m.column(1));
+
+		float values[4] = { 1.0f, -2.0f, 0.5f, 1.0f };
+		assert((view * vector_view<4, float>(values)) == m * v);
+
+		matrix_view<4, 4, float> target(buffer);
+		target.assign(matrix4f::identity());
+		assert(view.value() == matrix4f::identity());
+		target.column(3).assign(vector4f(5.0f, 6.0f, 7.0f, 1.0f));
+		assert(buffer[3] == 5.0f && buffer[7] == 6.0f && buffer[11] == 7.0f);
+	}
+
+	// Long contiguous views use the same kernels as long vectors
+	{
+		std::vector<float> embeddings(2 * 300);
+		for (std::size_t i = 0; i < embeddings.size(); i++)
+			embeddings[i] = std::sin(float(i));
+		vector_view<300, const float> a(embeddings.data()), b(embeddings.data() + 300);
+		assert(a * b == a.value() * b.value());
+		assert(std::fabs(a.distance_squared(b) - a.value().distance_squared(b.value())) <= 1e-3f);
+	}
+
+	// ----------------------------------------------------
+	// Batch operations
+	// ----------------------------------------------------
+
+	// Every kernel level the CPU supports agrees with the scalar one
+	{
+		const auto& scalar = details::kernels_for(simd_level::scalar);
+		matrix4f m = matrix4f::translate({-16.0f, -16.0f, 0.0f}) * matrix4f::rotate_z(degreesf(30.0f));
+
+		float in[4 * 7];
+		for (std::size_t i = 0; i < 4 * 7; i++)
+			in[i] = static_cast<float>(i) - 9.5f;
+
+		for (auto level : { simd_level::sse2, simd_level::avx2, simd_level::avx512 })
+		{
+			if (!cpu_features::current().supports(level))
+				continue;
+			const auto& kernels = details::kernels_for(level);
+
+			for (std::size_t count = 0; count <= 7; count++)
+			{
+				float expected[4 * 7], actual[4 * 7];
+				scalar.transform4(m.data(), in, expected, count);
+				kernels.transform4(m.data(), in, actual, count);
+				for (std::size_t i = 0; i < count * 4; i++)
+					assert(std::fabs(expected[i] - actual[i]) <= 1e-4f);
+
+				scalar.scale(in, expected, count * 4, 0.5f);
+				kernels.scale(in, actual, count * 4, 0.5f);
+				for (std::size_t i = 0; i < count * 4; i++)
+					assert(expected[i] == actual[i]);
+
+				float squares[4 * 7];
+				for (std::size_t i = 0; i < count * 4; i++)
+					squares[i] = in[i] * in[i];
+				squares[0] = 0.0f;
+				if (count > 0)
+				{
+					squares[1] = std::numeric_limits<float>::quiet_NaN();
+					squares[count * 4 - 1] = std::numeric_limits<float>::infinity();
+				}
+				scalar.rsqrt(squares, expected, count * 4);
+				kernels.rsqrt(squares, actual, count * 4);
+				for (std::size_t i = 0; i < count * 4; i++)
+				{
+					if (std::isnan(expected[i]))
+						assert(std::isnan(actual[i]));
+					else
+						assert(std::fabs(expected[i] - actual[i]) <= expected[i] * 1e-5f);
+				}
+				if (count > 0)
+					assert(expected[0] == 0.0f && actual[0] == 0.0f && expected[count * 4 - 1] == 0.0f && actual[count * 4 - 1] == 0.0f);
+
+				std::uint16_t expected_half[4 * 7], actual_half[4 * 7];
+				scalar.float_to_half(in, expected_half, count * 4);
+				kernels.float_to_half(in, actual_half, count * 4);
+				for (std::size_t i = 0; i < count * 4; i++)
+					assert(expected_half[i] == actual_half[i]);
+				scalar.half_to_float(expected_half, expected, count * 4);
+				kernels.half_to_float(expected_half, actual, count * 4);
+				for (std::size_t i = 0; i < count * 4; i++)
+					assert(expected[i] == actual[i]);
+			}
+
+			// Reductions over every length up to a few full unrolled iterations
+			float a[150], b[150];
+			for (std::size_t i = 0; i < 150; i++)
+			{
+				a[i] = std::sin(float(i));
+				b[i] = std::cos(float(i) * 0.7f);
+			}
+			for (std::size_t count = 0; count <= 150; count++)
+			{
+				assert(std::fabs(scalar.dot(a, b, count) - kernels.dot(a, b, count)) <= 1e-4f);
+				assert(std::fabs(scalar.distance_squared(a, b, count) - kernels.distance_squared(a, b, count)) <= 1e-4f * (1.0f + count));
+			}
+		}
+	}
+
+	{
+		matrix4f m = matrix4f::translate({-16.0f, -16.0f, 0.0f});
+		vector4f in[3] = { vector4f(0.0f, 32.0f, 0.0f, 1.0f), vector4f(1.0f, 2.0f, 3.0f, 1.0f), vector4f(1.0f, 2.0f, 3.0f, 0.0f) };
+		vector4f out[3];
+		transform(m, in, out, 3);
+		assert(out[0] == vector4f(-16.0f, 16.0f, 0.0f, 1.0f));
+		assert(out[1] == vector4f(-15.0f, -14.0f, 3.0f, 1.0f));
+		assert(out[2] == vector4f(1.0f, 2.0f, 3.0f, 0.0f));
+
+		scale(in, out, 3, 2.0f);
+		assert(out[1] == vector4f(2.0f, 4.0f, 6.0f, 2.0f));
+
+		vector3f directions[5] = { vector3f(3.0f, 0.0f, 4.0f), vector3f(), vector3f(1.0f, 1.0f, 1.0f), vector3f(0.0f, -2.0f, 0.0f), vector3f(1e3f, 2e3f, -5e2f) };
+		vector3f normals[5];
+		float lengths[5];
+		fast_normalize(directions, normals, 5);
+		fast_length(directions, lengths, 5);
+		for (std::size_t i = 0; i < 5; i++)
+		{
+			assert((normals[i] - directions[i].normalized()).length() <= 1e-5f);
+			assert(std::fabs(lengths[i] - directions[i].length()) <= directions[i].length() * 1e-5f);
+		}
+		normalize(directions, normals, 5);
+		length(directions, lengths, 5);
+		assert(normals[0] == vector3f(0.6f, 0.0f, 0.8f));
+		assert(normals[1] == vector3f());
+		assert(lengths[0] == 5.0f);
+
+		degreesf degrees[2] = { degreesf(180.0f), degreesf(-90.0f) };
+		radiansf radians[2];
+		convert(degrees, radians, 2);
+		assert(radians[0] == radiansf::pi());
+		assert(radians[1] == -radiansf::pi() / 2.0f);
+	}
+
+	// ----------------------------------------------------
+	// Attribute streams
+	// ----------------------------------------------------
+
+	// Streams address one member of interleaved vertices in place
+	{
+		static_assert(sizeof(vertex) == 36, "Test vertex must be 36 bytes");
+		vertex vertices[3] = {};
+		for (std::size_t i = 0; i < 3; i++)
+			vertices[i].uv = vector2f(static_cast<float>(i), 1.0f);
+
+		attribute_stream<vector2f> uvs = make_stream(vertices, 3, &vertex::uv);
+		assert(uvs.size() == 3 && uvs.stride() == 36);
+		assert(uvs[2] == vector2f(2.0f, 1.0f));
+		uvs[1] = vector2f(5.0f, 6.0f);
+		assert(vertices[1].uv == vector2f(5.0f, 6.0f));
+
+		float sum = 0.0f;
+		for (const vector2f& uv : uvs)
+			sum += uv.x();
+		assert(sum == 7.0f);
+
+		const vertex* readonly = vertices;
+		attribute_stream<const vector2f> from_const = make_stream(readonly, 3, &vertex::uv);
+		attribute_stream<const vector2f> converted = uvs;
+		assert(&from_const[2] == &converted[2]);
+
+		attribute_stream<vector3f> normals(reinterpret_cast<unsigned char*>(vertices), offsetof(vertex, normal), 3, sizeof(vertex));
+		assert(&normals[2] == &vertices[2].normal);
+		assert(uvs.subrange(1, 3).size() == 2 && &uvs.subrange(1, 3)[0] == &vertices[1].uv);
+	}
+
+	// Positions, normals and bounds over an interleaved buffer match the per-vertex results
+	{
+		std::mt19937 random(7);
+		std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+		std::vector<vertex> vertices(1000);
+		for (vertex& v : vertices)
+		{
+			v.position = vector3f(distribution(random), distribution(random), distribution(random));
+			v.normal = vector3f(distribution(random), distribution(random), distribution(random)).normalized();
+		}
+		const std::vector<vertex> original = vertices;
+
+		matrix4f m = matrix4f::translate({1.0f, -2.0f, 3.0f}) * matrix4f::rotate_y(degreesf(40.0f)) * matrix4f::scale({2.0f, 0.5f, 1.0f});
+		attribute_stream<vector3f> positions = make_stream(vertices.data(), vertices.size(), &vertex::position);
+		attribute_stream<vector3f> normals = make_stream(vertices.data(), vertices.size(), &vertex::normal);
+		transform_points(m, positions);
+		transform_normals(m, normals);
+		for (std::size_t i = 0; i < vertices.size(); i++)
+		{
+			vector4f expected = m * vector4f(original[i].position, 1.0f);
+			for (std::size_t k = 0; k < 3; k++)
+				assert(std::fabs(vertices[i].position[k] - expected[k]) <= 1e-4f);
+			assert(std::fabs(vertices[i].normal.length() - 1.0f) <= 1e-5f);
+			assert(vertices[i].uv == original[i].uv);
+
+			// Normals stay perpendicular to transformed tangents under non-uniform scale
+			vector3f tangent = vector3f(0.0f, 0.0f, 1.0f) ^ original[i].normal;
+			vector4f transformed = m * vector4f(tangent, 0.0f);
+			assert(std::fabs(vertices[i].normal * vector3f(transformed[0], transformed[1], transformed[2])) <= 1e-4f * (tangent.length() * 2.0f + 1.0f));
+		}
+
+		// The generic path agrees with the kernels
+		matrix<4, 4, double> md(m.data()[0], m.data()[1], m.data()[2], m.data()[3], m.data()[4], m.data()[5], m.data()[6], m.data()[7],
+			m.data()[8], m.data()[9], m.data()[10], m.data()[11], m.data()[12], m.data()[13], m.data()[14], m.data()[15]);
+		std::vector<vector<3, double>> doubles(original.size());
+		for (std::size_t i = 0; i < original.size(); i++)
+			doubles[i] = vector<3, double>(original[i].position[0], original[i].position[1], original[i].position[2]);
+		transform_points(md, attribute_stream<vector<3, double>>(doubles.data(), doubles.size()));
+		for (std::size_t i = 0; i < original.size(); i++)
+		{
+			for (std::size_t k = 0; k < 3; k++)
+				assert(std::fabs(doubles[i][k] - vertices[i].position[k]) <= 1e-4);
+		}
+
+		vector3f minimum, maximum;
+		bounds(positions, minimum, maximum);
+		vector<3, double> minimum_d, maximum_d;
+		bounds(attribute_stream<vector<3, double>>(doubles.data(), doubles.size()), minimum_d, maximum_d);
+		for (std::size_t k = 0; k < 3; k++)
+		{
+			float lower = vertices[0].position[k], upper = lower;
+			for (const vertex& v : vertices)
+			{
+				lower = std::min(lower, v.position[k]);
+				upper = std::max(upper, v.position[k]);
+			}
+			assert(minimum[k] == lower && maximum[k] == upper);
+			assert(std::fabs(minimum_d[k] - lower) <= 1e-4 && std::fabs(maximum_d[k] - upper) <= 1e-4);
+		}
+
+		bounds(positions.subrange(0, 0), minimum, maximum);
+		assert(minimum[0] > maximum[0]);
+	}
+
+	// Every strided kernel level agrees with the scalar one for any count, stride and in-place use
+	{
+		const auto& scalar = details::kernels_for(simd_level::scalar);
+		matrix4f m = matrix4f::translate({4.0f, 5.0f, -6.0f}) * matrix4f::rotate_x(degreesf(25.0f));
+		vertex in[40] = {};
+		for (std::size_t i = 0; i < 40; i++)
+			in[i].position = vector3f(static_cast<float>(i) - 20.0f, static_cast<float>(i * i) * 0.1f, 3.0f - static_cast<float>(i));
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&in[0].position);
+
+		for (auto level : { simd_level::sse2, simd_level::avx2, simd_level::avx512 })
+		{
+			if (!cpu_features::current().supports(level))
+				continue;
+			const auto& kernels = details::kernels_for(level);
+
+			for (std::size_t count = 0; count <= 40; count++)
+			{
+				vector3f expected[40], actual[40];
+				scalar.transform3(m.data(), bytes, sizeof(vertex), reinterpret_cast<unsigned char*>(expected), sizeof(vector3f), count, 1.0f);
+				kernels.transform3(m.data(), bytes, sizeof(vertex), reinterpret_cast<unsigned char*>(actual), sizeof(vector3f), count, 1.0f);
+				for (std::size_t i = 0; i < count; i++)
+					assert((expected[i] - actual[i]).length() <= 1e-4f);
+
+				vertex copy[40];
+				std::copy(in, in + 40, copy);
+				kernels.transform3(m.data(), reinterpret_cast<unsigned char*>(&copy[0].position), sizeof(vertex), reinterpret_cast<unsigned char*>(&copy[0].position), sizeof(vertex), count, 0.0f);
+				scalar.transform3(m.data(), bytes, sizeof(vertex), reinterpret_cast<unsigned char*>(expected), sizeof(vector3f), count, 0.0f);
+				for (std::size_t i = 0; i < 40; i++)
+					assert(i < count ? (expected[i] - copy[i].position).length() <= 1e-4f : copy[i].position == in[i].position);
+
+				float lower[2][3], upper[2][3];
+				scalar.bounds3(bytes, sizeof(vertex), count, lower[0], upper[0]);
+				kernels.bounds3(bytes, sizeof(vertex), count, lower[1], upper[1]);
+				for (std::size_t c = 0; c < 3; c++)
+					assert(lower[0][c] == lower[1][c] && upper[0][c] == upper[1][c]);
+			}
+		}
+
+		// NaN components are skipped at every level, wherever they fall
+		vertex holes[40];
+		std::copy(in, in + 40, holes);
+		for (std::size_t i : { 0, 3, 9, 17, 39 })
+			holes[i].position[i % 3] = std::numeric_limits<float>::quiet_NaN();
+		holes[21].position = vector3f(std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::quiet_NaN());
+		const unsigned char* hole_bytes = reinterpret_cast<const unsigned char*>(&holes[0].position);
+		float lower[3], upper[3];
+		scalar.bounds3(hole_bytes, sizeof(vertex), 40, lower, upper);
+		for (std::size_t c = 0; c < 3; c++)
+		{
+			float expected_lower = std::numeric_limits<float>::infinity(), expected_upper = -std::numeric_limits<float>::infinity();
+			for (const vertex& v : holes)
+			{
+				if (!std::isnan(v.position[c]))
+				{
+					expected_lower = std::min(expected_lower, v.position[c]);
+					expected_upper = std::max(expected_upper, v.position[c]);
+				}
+			}
+			assert(lower[c] == expected_lower && upper[c] == expected_upper);
+		}
+		for (auto level : { simd_level::sse2, simd_level::avx2, simd_level::avx512 })
+		{
+			if (!cpu_features::current().supports(level))
+				continue;
+			float level_lower[3], level_upper[3];
+			details::kernels_for(level).bounds3(hole_bytes, sizeof(vertex), 40, level_lower, level_upper);
+			for (std::size_t c = 0; c < 3; c++)
+				assert(level_lower[c] == lower[c] && level_upper[c] == upper[c]);
+		}
+	}
+
 	std::cout << "All tests completed successfully.\n";
 	
 	return 0;
@@ -0,0 +1,345 @@
+#include <iostream>
+#include <vector>
+#include <random>
+
+#include <cassert>
+
+#include <accel/search>
+
+using namespace accel;
+
+using embedding = vector<64, float>;
+
+// Exhaustive double-precision reference, best first
+static std::vector<match> reference(const std::vector<embedding>& data, const embedding& query, accel::metric measure, std::size_t k)
+{
+	std::vector<match> result;
+	for (std::size_t i = 0; i < data.size(); i++)
+	{
+		double dot = 0.0, distance = 0.0, lengths[2] = { 0.0, 0.0 };
+		for (std::size_t d = 0; d < embedding::size(); d++)
+		{
+			dot += double(data[i][d]) * query[d];
+			distance += (double(data[i][d]) - query[d]) * (double(data[i][d]) - query[d]);
+			lengths[0] += double(data[i][d]) * data[i][d];
+			lengths[1] += double(query[d]) * query[d];
+		}
+		double score = measure == accel::metric::l2 ? distance : measure == accel::metric::cosine ? dot / std::sqrt(lengths[0] * lengths[1]) : dot;
+		result.push_back(match{ std::uint32_t(i), float(score) });
+	}
+	auto order = [measure](const match& a, const match& b) { return measure == accel::metric::l2 ? a.score < b.score : a.score > b.score; };
+	std::sort(result.begin(), result.end(), order);
+	result.resize(std::min(k, result.size()));
+	return result;
+}
+
+int main(int argc, char* argv[])
+{
+	// ----------------------------------------------------
+	// Kernels
+	// ----------------------------------------------------
+
+	// Every kernel level the CPU supports agrees with the scalar one
+	{
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+		std::vector<float> queries(7 * 41), rows(5 * 41);
+		std::vector<std::uint16_t> halves(rows.size());
+		std::vector<std::int8_t> bytes(rows.size());
+		for (auto& value : queries)
+			value = coordinate(random);
+		for (std::size_t i = 0; i < rows.size(); i++)
+		{
+			rows[i] = coordinate(random);
+			halves[i] = details::float_to_half_bits(rows[i]);
+			bytes[i] = static_cast<std::int8_t>(rows[i] * 127.0f);
+		}
+
+		const auto& scalar = details::similarity_kernels_for(simd_level::scalar);
+		for (auto level : { simd_level::sse2, simd_level::avx2, simd_level::avx512 })
+		{
+			if (!cpu_features::current().supports(level))
+				continue;
+			const auto& kernels = details::similarity_kernels_for(level);
+
+			for (std::size_t dimensions : { 1, 4, 8, 13, 41 })
+			{
+				for (std::size_t query_count = 0; query_count <= 7; query_count++)
+				{
+					float expected[7 * 5], actual[7 * 5];
+					scalar.dot_float(queries.data(), query_count, rows.data(), 5, dimensions, expected);
+					kernels.dot_float(queries.data(), query_count, rows.data(), 5, dimensions, actual);
+					for (std::size_t i = 0; i < query_count * 5; i++)
+						assert(std::fabs(expected[i] - actual[i]) <= 1e-5f);
+					scalar.dot_half(queries.data(), query_count, halves.data(), 5, dimensions, expected);
+					kernels.dot_half(queries.data(), query_count, halves.data(), 5, dimensions, actual);
+					for (std::size_t i = 0; i < query_count * 5; i++)
+						assert(std::fabs(expected[i] - actual[i]) <= 1e-5f);
+					scalar.dot_int8(queries.data(), query_count, bytes.data(), 5, dimensions, expected);
+					kernels.dot_int8(queries.data(), query_count, bytes.data(), 5, dimensions, actual);
+					for (std::size_t i = 0; i < query_count * 5; i++)
+						assert(std::fabs(expected[i] - actual[i]) <= 1e-3f);
+				}
+			}
+		}
+	}
+
+	// Code scans agree too, including sums that need all 16 bits
+	{
+		std::mt19937 random(3);
+		std::vector<std::uint8_t> codes(3 * 10 * 16), table(20 * 16);
+		for (auto& code : codes)
+			code = static_cast<std::uint8_t>(random());
+		for (auto& entry : table)
+			entry = static_cast<std::uint8_t>(random());
+
+		const auto& scalar = details::similarity_kernels_for(simd_level::scalar);
+		std::uint16_t expected[3 * 16], actual[3 * 16];
+		scalar.scan(codes.data(), 3, 10, table.data(), expected);
+		for (std::size_t j = 0; j < 16; j++)
+		{
+			unsigned sum = 0;
+			for (std::size_t p = 0; p < 10; p++)
+				sum += table[p * 32 + (codes[p * 16 + j] & 15)] + table[p * 32 + 16 + (codes[p * 16 + j] >> 4)];
+			assert(expected[j] == sum);
+		}
+
+		for (auto level : { simd_level::sse2, simd_level::avx2, simd_level::avx512 })
+		{
+			if (!cpu_features::current().supports(level))
+				continue;
+			details::similarity_kernels_for(level).scan(codes.data(), 3, 10, table.data(), actual);
+			assert(std::equal(expected, expected + 3 * 16, actual));
+		}
+	}
+
+	// ----------------------------------------------------
+	// Flat index
+	// ----------------------------------------------------
+
+	std::mt19937 random(2);
+	std::normal_distribution<float> coordinate(0.0f, 1.0f);
+	std::vector<embedding> data(3000), queries(70);
+	for (auto& v : data)
+	{
+		for (std::size_t d = 0; d < v.size(); d++)
+			v[d] = coordinate(random);
+	}
+	for (auto& v : queries)
+	{
+		for (std::size_t d = 0; d < v.size(); d++)
+			v[d] = coordinate(random);
+	}
+	// One query sits on a stored vector
+	queries[3] = data[1234];
+
+	// Unquantized search finds exactly the reference matches, and threads do not change the result
+	{
+		const std::size_t k = 10;
+		for (auto measure : { accel::metric::inner_product, accel::metric::l2, accel::metric::cosine })
+		{
+			flat_index<64> index(measure);
+			index.add(data.data(), 1000);
+			index.add(data.data() + 1000, data.size() - 1000);
+			assert(index.size() == data.size() && index.metric() == measure);
+
+			std::vector<match> found(queries.size() * k), parallel(queries.size() * k);
+			index.search(queries.data(), queries.size(), k, found.data());
+			tiling options;
+			options.threads = 4;
+			options.tile_size = 500;
+			index.search(queries.data(), queries.size(), k, parallel.data(), options);
+
+			for (std::size_t q = 0; q < queries.size(); q++)
+			{
+				auto expected = reference(data, queries[q], measure, k);
+				for (std::size_t i = 0; i < k; i++)
+				{
+					const match& hit = found[q * k + i];
+					assert(hit.index == expected[i].index);
+					assert(std::fabs(hit.score - expected[i].score) <= 1e-3f * std::max(1.0f, std::fabs(expected[i].score)));
+					assert(parallel[q * k + i].index == hit.index && parallel[q * k + i].score == hit.score);
+				}
+			}
+			if (measure == accel::metric::l2)
+				assert(found[3 * k].index == 1234 && found[3 * k].score == 0.0f);
+			else if (measure == accel::metric::cosine)
+				assert(found[3 * k].index == 1234 && std::fabs(found[3 * k].score - 1.0f) <= 1e-5f);
+		}
+	}
+
+	// Quantized storage keeps most of the true neighbours
+	{
+		const std::size_t k = 10;
+		for (auto storage : { accel::quantization::half, accel::quantization::int8 })
+		{
+			for (auto measure : { accel::metric::inner_product, accel::metric::l2, accel::metric::cosine })
+			{
+				flat_index<64> index(measure, storage);
+				index.add(data.data(), data.size());
+
+				float error = 0.0f;
+				for (std::size_t i = 0; i < 100; i++)
+				{
+					embedding stored = measure == accel::metric::cosine ? data[i].normalized() : data[i];
+					error = std::max(error, index.reconstruct(i).distance(stored) / stored.length());
+				}
+				assert(error <= (storage == accel::quantization::half ? 1e-3f : 2e-2f));
+
+				std::vector<match> found(queries.size() * k);
+				index.search(queries.data(), queries.size(), k, found.data());
+				std::size_t hits = 0;
+				for (std::size_t q = 0; q < queries.size(); q++)
+				{
+					auto expected = reference(data, queries[q], measure, k);
+					for (std::size_t i = 0; i < k; i++)
+					{
+						for (std::size_t j = 0; j < k; j++)
+							hits += found[q * k + i].index == expected[j].index;
+					}
+				}
+				assert(hits >= queries.size() * k * 9 / 10);
+			}
+		}
+	}
+
+	// Small and empty indexes pad the results
+	{
+		flat_index<64> index(accel::metric::l2);
+		match found[4];
+		index.search(queries.data(), 1, 4, found);
+		assert(found[0].index == std::numeric_limits<std::uint32_t>::max() && std::isinf(found[0].score));
+
+		index.add(data.data(), 2);
+		index.search(queries.data(), 1, 4, found);
+		assert(found[0].index < 2 && found[1].index < 2 && found[0].index != found[1].index);
+		assert(found[0].score <= found[1].score);
+		assert(found[2].index == std::numeric_limits<std::uint32_t>::max() && found[3].score == std::numeric_limits<float>::infinity());
+
+		flat_index<64> similarity;
+		similarity.add(data.data(), 1);
+		similarity.search(queries.data(), 1, 2, found);
+		assert(found[0].index == 0 && found[1].score == -std::numeric_limits<float>::infinity());
+	}
+
+	// ----------------------------------------------------
+	// Inverted file index
+	// ----------------------------------------------------
+
+	// Recall rises with the number of lists probed, and probing every list nearly always finds the true nearest
+	// neighbour among the first k
+	{
+		std::vector<embedding> centers(40), clustered(6000);
+		for (auto& v : centers)
+		{
+			for (std::size_t d = 0; d < v.size(); d++)
+				v[d] = coordinate(random) * 4.0f;
+		}
+		for (std::size_t i = 0; i < clustered.size(); i++)
+		{
+			for (std::size_t d = 0; d < embedding::size(); d++)
+				clustered[i][d] = centers[i % centers.size()][d] + coordinate(random);
+		}
+		std::vector<embedding> probes_queries(clustered.begin(), clustered.begin() + 50);
+		for (auto& v : probes_queries)
+		{
+			for (std::size_t d = 0; d < v.size(); d++)
+				v[d] += coordinate(random) * 0.5f;
+		}
+
+		ivf_pq_index<64> index(32, 32);
+		index.train(clustered.data(), 3000);
+		assert(index.trained() && index.empty());
+		index.add(clustered.data(), 2500);
+		index.add(clustered.data() + 2500, clustered.size() - 2500);
+		assert(index.size() == clustered.size());
+
+		const std::size_t k = 10;
+		std::vector<std::vector<match>> expected;
+		for (const auto& query : probes_queries)
+			expected.push_back(reference(clustered, query, accel::metric::l2, 1));
+
+		double previous = 0.0;
+		for (std::size_t probes : { 1, 4, 32 })
+		{
+			std::vector<match> found(probes_queries.size() * k), parallel(found.size());
+			index.search(probes_queries.data(), probes_queries.size(), k, found.data(), probes);
+			tiling options;
+			options.threads = 3;
+			options.tile_size = 7;
+			index.search(probes_queries.data(), probes_queries.size(), k, parallel.data(), probes, options);
+
+			std::size_t hits = 0;
+			for (std::size_t q = 0; q < probes_queries.size(); q++)
+			{
+				for (std::size_t i = 0; i < k; i++)
+				{
+					assert(parallel[q * k + i].index == found[q * k + i].index && parallel[q * k + i].score == found[q * k + i].score);
+					assert(i == 0 || found[q * k + i - 1].score <= found[q * k + i].score);
+					hits += found[q * k + i].index == expected[q][0].index;
+				}
+			}
+			double recall = double(hits) / probes_queries.size();
+			assert(recall >= previous);
+			previous = recall;
+		}
+		assert(previous >= 0.9);
+
+		// A stored vector's estimate is its quantization error, which is far below the distance to any other vector
+		match self[2];
+		index.search(clustered.data() + 5, 1, 2, self, 32);
+		float nearest_other = std::numeric_limits<float>::infinity();
+		for (std::size_t i = 0; i < clustered.size(); i++)
+		{
+			if (i != 5)
+				nearest_other = std::min(nearest_other, clustered[i].distance_squared(clustered[5]));
+		}
+		assert(self[0].index == 5 && self[0].score < 0.5f * nearest_other);
+		assert(self[1].score >= self[0].score);
+	}
+
+	// Invalid layouts and untrained indexes are rejected, and untrained searches come back empty
+	{
+		bool thrown = false;
+		try { ivf_pq_index<64> invalid(8, 3); }
+		catch (const std::invalid_argument&) { thrown = true; }
+		assert(thrown);
+
+		ivf_pq_index<64> untrained(8, 16);
+		thrown = false;
+		try { untrained.add(data.data(), 1); }
+		catch (const std::logic_error&) { thrown = true; }
+		assert(thrown);
+
+		match found[2];
+		untrained.search(queries.data(), 1, 2, found);
+		assert(found[0].index == std::numeric_limits<std::uint32_t>::max() && std::isinf(found[1].score));
+	}
+
+	// The default layout is valid for every even dimension, including those where Dimensions / 2 is odd
+	{
+		assert(ivf_pq_index<64>().subspaces() == 32);
+		assert(ivf_pq_index<10>().subspaces() == 2);
+		assert(ivf_pq_index<18>().subspaces() == 6);
+		assert(ivf_pq_index<2>().subspaces() == 2);
+
+		std::vector<vector<6, float>> small(500);
+		for (auto& v : small)
+		{
+			for (std::size_t d = 0; d < v.size(); d++)
+				v[d] = coordinate(random);
+		}
+		ivf_pq_index<6> index(8);
+		assert(index.subspaces() == 2);
+		index.train(small.data(), small.size());
+		index.add(small.data(), small.size());
+		match found[4];
+		index.search(small.data(), 1, 4, found, 8);
+		for (const match& m : found)
+			assert(m.index < small.size());
+	}
+
+	std::cout << "All tests completed successfully.\n";
+
+	return 0;
+}
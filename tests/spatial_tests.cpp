@@ -0,0 +1,362 @@
+#include <iostream>
+#include <vector>
+#include <random>
+
+#include <cassert>
+
+#include <accel/spatial>
+
+using namespace accel;
+
+int main(int argc, char* argv[])
+{
+	// ----------------------------------------------------
+	// Kernels
+	// ----------------------------------------------------
+
+	// Every kernel level the CPU supports agrees with the scalar one
+	{
+		std::mt19937 random(5);
+		std::vector<std::uint32_t> axes(3 * 100);
+		for (auto& axis : axes)
+			axis = random();
+
+		for (auto level : { simd_level::sse2, simd_level::avx2, simd_level::avx512 })
+		{
+			if (!cpu_features::current().supports(level))
+				continue;
+
+			const auto& scalar2 = details::curve_kernels_for<2>(simd_level::scalar);
+			const auto& kernels2 = details::curve_kernels_for<2>(level);
+			std::uint64_t expected[100], actual[100];
+			std::uint32_t expected_axes[300], actual_axes[300];
+			scalar2.morton_encode(axes.data(), expected, 100);
+			kernels2.morton_encode(axes.data(), actual, 100);
+			assert(std::equal(expected, expected + 100, actual));
+			scalar2.morton_decode(expected, expected_axes, 100);
+			kernels2.morton_decode(expected, actual_axes, 100);
+			assert(std::equal(expected_axes, expected_axes + 200, actual_axes));
+			scalar2.hilbert_encode(axes.data(), expected, 100, 32);
+			kernels2.hilbert_encode(axes.data(), actual, 100, 32);
+			assert(std::equal(expected, expected + 100, actual));
+			scalar2.hilbert_decode(expected, expected_axes, 100, 32);
+			kernels2.hilbert_decode(expected, actual_axes, 100, 32);
+			assert(std::equal(expected_axes, expected_axes + 200, actual_axes));
+
+			// Three axes keep 21 bits each
+			std::vector<std::uint32_t> axes3(axes);
+			for (auto& axis : axes3)
+				axis &= 0x1FFFFF;
+			const auto& scalar3 = details::curve_kernels_for<3>(simd_level::scalar);
+			const auto& kernels3 = details::curve_kernels_for<3>(level);
+			scalar3.morton_encode(axes3.data(), expected, 100);
+			kernels3.morton_encode(axes3.data(), actual, 100);
+			assert(std::equal(expected, expected + 100, actual));
+			scalar3.morton_decode(expected, expected_axes, 100);
+			kernels3.morton_decode(expected, actual_axes, 100);
+			assert(std::equal(expected_axes, expected_axes + 300, actual_axes));
+			assert(std::equal(axes3.begin(), axes3.end(), actual_axes));
+			scalar3.hilbert_encode(axes3.data(), expected, 100, 21);
+			kernels3.hilbert_encode(axes3.data(), actual, 100, 21);
+			assert(std::equal(expected, expected + 100, actual));
+			scalar3.hilbert_decode(expected, expected_axes, 100, 21);
+			kernels3.hilbert_decode(expected, actual_axes, 100, 21);
+			assert(std::equal(axes3.begin(), axes3.end(), actual_axes));
+		}
+
+		// The BMI2 kernels are only selected where PDEP is fast, but stay correct wherever BMI2 exists
+		assert(!cpu_features::current().fast_pdep || cpu_features::current().bmi2);
+#if defined(ACCEL_CURVES_BMI2)
+		if (cpu_features::current().bmi2)
+		{
+			std::uint64_t expected[100], actual[100];
+			details::morton_encode_scalar<2>(axes.data(), expected, 100);
+			details::morton_encode_bmi2<2>(axes.data(), actual, 100);
+			assert(std::equal(expected, expected + 100, actual));
+		}
+#endif
+	}
+
+	// ----------------------------------------------------
+	// Space-filling curves
+	// ----------------------------------------------------
+
+	// Morton keys interleave the axes with x in the lowest bit
+	{
+		assert(morton_encode(point2u(1u, 0u)) == 1);
+		assert(morton_encode(point2u(0u, 1u)) == 2);
+		assert(morton_encode(point2u(3u, 3u)) == 15);
+		assert(morton_encode(point2u(0xFFFFFFFFu, 0u)) == 0x5555555555555555ull);
+		assert(morton_encode(point3u(1u, 1u, 1u)) == 7);
+		assert(morton_encode(point3u(0u, 0u, 0x1FFFFFu)) == 0x1249249249249249ull << 2);
+		assert(morton_decode<2>(14) == point2u(2u, 3u));
+		assert(morton_decode<3>(0x38) == point3u(2u, 2u, 2u));
+
+		std::mt19937 random(1);
+		for (int i = 0; i < 1000; i++)
+		{
+			auto p2 = point2u(std::uint32_t(random()), std::uint32_t(random()));
+			auto p3 = point3u(std::uint32_t(random() & 0x1FFFFF), std::uint32_t(random() & 0x1FFFFF), std::uint32_t(random() & 0x1FFFFF));
+			assert(morton_decode<2>(morton_encode(p2)) == p2);
+			assert(morton_decode<3>(morton_encode(p3)) == p3);
+			assert(hilbert_decode<2>(hilbert_encode(p2)) == p2);
+			assert(hilbert_decode<3>(hilbert_encode(p3)) == p3);
+		}
+	}
+
+	// Hilbert keys visit every cell once, and consecutive keys are neighbouring cells
+	{
+		std::vector<bool> seen(16 * 16);
+		point2u previous;
+		for (std::uint64_t key = 0; key < 16 * 16; key++)
+		{
+			auto p = hilbert_decode<2>(key, 4);
+			assert(hilbert_encode(p, 4) == key);
+			assert(p.x() < 16 && p.y() < 16 && !seen[p.y() * 16 + p.x()]);
+			seen[p.y() * 16 + p.x()] = true;
+			if (key > 0)
+				assert(std::abs(int(p.x()) - int(previous.x())) + std::abs(int(p.y()) - int(previous.y())) == 1);
+			previous = p;
+		}
+		assert(hilbert_decode<2>(0, 4) == point2u(0u, 0u));
+
+		point3u previous3;
+		for (std::uint64_t key = 0; key < 8 * 8 * 8; key++)
+		{
+			auto p = hilbert_decode<3>(key, 3);
+			assert(hilbert_encode(p, 3) == key);
+			if (key > 0)
+			{
+				int distance = 0;
+				for (std::size_t axis = 0; axis < 3; axis++)
+					distance += std::abs(int(p[axis]) - int(previous3[axis]));
+				assert(distance == 1);
+			}
+			previous3 = p;
+		}
+	}
+
+	// Batch encoders match the single-point ones, and floating-point points are quantized over their box
+	{
+		std::mt19937 random(2);
+		std::vector<point3i> integers(1000);
+		std::vector<point3f> floats(1000);
+		std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+		for (std::size_t i = 0; i < integers.size(); i++)
+		{
+			integers[i] = point3i(int(random() & 0xFFFFF), int(random() & 0xFFFFF), int(random() & 0xFFFFF));
+			floats[i] = point3f(coordinate(random), coordinate(random), coordinate(random));
+		}
+
+		std::vector<std::uint64_t> keys(integers.size());
+		morton_encode(integers.data(), keys.data(), keys.size());
+		for (std::size_t i = 0; i < keys.size(); i++)
+			assert(keys[i] == morton_encode(integers[i]));
+		hilbert_encode(integers.data(), keys.data(), keys.size(), 20);
+		for (std::size_t i = 0; i < keys.size(); i++)
+			assert(keys[i] == hilbert_encode(integers[i], 20));
+
+		std::vector<point3u> decoded(keys.size());
+		hilbert_decode(keys.data(), decoded.data(), keys.size(), 20);
+		for (std::size_t i = 0; i < keys.size(); i++)
+			assert(decoded[i] == point3u(unsigned(integers[i].x()), unsigned(integers[i].y()), unsigned(integers[i].z())));
+
+		point3f minimum(-10.0f, -10.0f, -10.0f), maximum(10.0f, 10.0f, 10.0f);
+		morton_encode(floats.data(), keys.data(), keys.size(), minimum, maximum);
+		const double cells = double(1u << 21) - 1.0;
+		for (std::size_t i = 0; i < keys.size(); i++)
+		{
+			auto cell = morton_decode<3>(keys[i]);
+			for (std::size_t axis = 0; axis < 3; axis++)
+				assert(std::abs(double(cell[axis]) - (floats[i][axis] + 10.0) / 20.0 * cells) <= 1.0);
+		}
+
+		// Points outside the box clamp to its faces
+		point3f outside[2] = { point3f(-20.0f, 0.0f, 20.0f), point3f(10.0f, 10.0f, 10.0f) };
+		std::uint64_t outside_keys[2];
+		morton_encode(outside, outside_keys, 2, minimum, maximum);
+		assert(morton_decode<3>(outside_keys[0]).x() == 0 && morton_decode<3>(outside_keys[0]).z() == 0x1FFFFF);
+		assert(outside_keys[1] == 0x7FFFFFFFFFFFFFFFull);
+	}
+
+	// ----------------------------------------------------
+	// Sorting
+	// ----------------------------------------------------
+
+	// Radix sort is stable and matches a comparison sort
+	{
+		std::mt19937_64 random(3);
+		for (std::size_t count : { 0, 1, 2, 1000, 70000 })
+		{
+			for (std::uint64_t mask : { 0xFFFFFFFFFFFFFFFFull, 0x0000000000000F00ull, 0xFF000000000000FFull })
+			{
+				std::vector<std::uint64_t> keys(count);
+				std::vector<std::uint32_t> values(count);
+				std::vector<std::pair<std::uint64_t, std::uint32_t>> expected(count);
+				for (std::size_t i = 0; i < count; i++)
+				{
+					keys[i] = random() & mask;
+					values[i] = std::uint32_t(i);
+					expected[i] = { keys[i], values[i] };
+				}
+				std::stable_sort(expected.begin(), expected.end(), [](const std::pair<std::uint64_t, std::uint32_t>& a, const std::pair<std::uint64_t, std::uint32_t>& b) { return a.first < b.first; });
+				radix_sort(keys.data(), values.data(), count);
+				for (std::size_t i = 0; i < count; i++)
+					assert(keys[i] == expected[i].first && values[i] == expected[i].second);
+			}
+		}
+	}
+
+	// Spatial sorting permutes the points into curve order
+	{
+		std::mt19937 random(4);
+		std::uniform_real_distribution<double> coordinate(0.0, 1.0);
+		std::vector<point2d> points(5000);
+		for (auto& p : points)
+			p = point2d(coordinate(random), coordinate(random));
+		std::vector<point2d> original(points);
+
+		for (auto order : { curve::morton, curve::hilbert })
+		{
+			spatial_sort(points.data(), points.size(), order);
+
+			point2d minimum, maximum;
+			details::bounds(points.data(), points.size(), minimum, maximum);
+			std::vector<std::uint64_t> keys(points.size());
+			if (order == curve::morton)
+				morton_encode(points.data(), keys.data(), keys.size(), minimum, maximum);
+			else
+				hilbert_encode(points.data(), keys.data(), keys.size(), minimum, maximum);
+			assert(std::is_sorted(keys.begin(), keys.end()));
+
+			auto less = [](const point2d& a, const point2d& b) { return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y()); };
+			std::vector<point2d> sorted(points), expected(original);
+			std::sort(sorted.begin(), sorted.end(), less);
+			std::sort(expected.begin(), expected.end(), less);
+			assert(sorted == expected);
+		}
+
+		// Hilbert order keeps consecutive points close: the path through them is far shorter than the input order
+		double path = 0.0, original_path = 0.0;
+		for (std::size_t i = 1; i < points.size(); i++)
+		{
+			path += (points[i] - points[i - 1]).operator vector2d().length();
+			original_path += (original[i] - original[i - 1]).operator vector2d().length();
+		}
+		assert(path * 10.0 < original_path);
+	}
+
+	// ----------------------------------------------------
+	// Nearest neighbors
+	// ----------------------------------------------------
+
+	// Both trees agree with a brute-force search, one query at a time and in batches
+	{
+		std::mt19937 random(6);
+		std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+		std::vector<point3f> points(20000);
+		for (auto& p : points)
+			p = point3f(coordinate(random), coordinate(random), coordinate(random));
+		// Duplicates and a cluster exercise ties and deep cells
+		for (std::size_t i = 0; i < 100; i++)
+			points[i] = points[100];
+		for (std::size_t i = 200; i < 400; i++)
+			points[i] = point3f(0.5f + coordinate(random) * 1e-5f, 0.5f, 0.5f);
+
+		std::vector<point3f> queries(200);
+		for (auto& q : queries)
+			q = point3f(coordinate(random) * 1.2f, coordinate(random) * 1.2f, coordinate(random) * 1.2f);
+		queries[0] = points[100];
+		queries[1] = point3f(0.5f, 0.5f, 0.5f);
+
+		kd_tree3f kd(points.data(), points.size());
+		octreef oct(points.data(), points.size());
+		assert(kd.size() == points.size() && oct.size() == points.size());
+
+		for (std::size_t k : { 1, 5, 16 })
+		{
+			std::vector<neighbor<float>> kd_batch(queries.size() * k), oct_batch(queries.size() * k);
+			tiling options;
+			options.threads = 4;
+			options.tile_size = 16;
+			kd.nearest(queries.data(), queries.size(), k, kd_batch.data(), options);
+			oct.nearest(queries.data(), queries.size(), k, oct_batch.data(), options);
+
+			for (std::size_t q = 0; q < queries.size(); q++)
+			{
+				std::vector<float> expected(points.size());
+				for (std::size_t i = 0; i < points.size(); i++)
+					expected[i] = details::distance_squared(points[i], queries[q]);
+				std::sort(expected.begin(), expected.end());
+
+				neighbor<float> found[16];
+				for (int tree = 0; tree < 2; tree++)
+				{
+					std::size_t count = tree == 0 ? kd.nearest(queries[q], k, found) : oct.nearest(queries[q], k, found);
+					const neighbor<float>* batch = (tree == 0 ? kd_batch.data() : oct_batch.data()) + q * k;
+					assert(count == k);
+					for (std::size_t i = 0; i < k; i++)
+					{
+						assert(std::abs(found[i].distance_squared - expected[i]) <= 1e-6f);
+						assert(found[i].distance_squared == details::distance_squared(points[found[i].index], queries[q]));
+						assert(batch[i].index == found[i].index && batch[i].distance_squared == found[i].distance_squared);
+					}
+				}
+			}
+		}
+
+		for (float radius : { 0.0f, 0.05f, 0.3f })
+		{
+			std::vector<std::vector<neighbor<float>>> kd_batch(queries.size()), oct_batch(queries.size());
+			kd.within(queries.data(), queries.size(), radius, kd_batch.data());
+			oct.within(queries.data(), queries.size(), radius, oct_batch.data());
+			for (std::size_t q = 0; q < queries.size(); q++)
+			{
+				std::vector<std::uint32_t> expected;
+				for (std::size_t i = 0; i < points.size(); i++)
+				{
+					if (details::distance_squared(points[i], queries[q]) <= radius * radius)
+						expected.push_back(std::uint32_t(i));
+				}
+				for (auto* found : { &kd_batch[q], &oct_batch[q] })
+				{
+					std::vector<std::uint32_t> indices;
+					for (const auto& n : *found)
+						indices.push_back(n.index);
+					std::sort(indices.begin(), indices.end());
+					assert(indices == expected);
+				}
+			}
+			assert(kd_batch[0].size() >= 101 && oct_batch[0].size() >= 101);
+		}
+	}
+
+	// Small and empty trees return what they have, and batches pad the rest
+	{
+		kd_tree<2, double> empty;
+		neighbor<double> found[4];
+		assert(empty.nearest(point2d(0.0, 0.0), 4, found) == 0);
+
+		point2d points[3] = { point2d(0.0, 0.0), point2d(1.0, 0.0), point2d(3.0, 0.0) };
+		kd_tree<2, double> kd(points, 3, 1);
+		assert(kd.nearest(point2d(0.9, 0.0), 4, found) == 3);
+		assert(found[0].index == 1 && found[1].index == 0 && found[2].index == 2);
+		assert(kd.nearest(point2d(0.9, 0.0), 0, found) == 0);
+
+		point3f cloud[2] = { point3f(1.0f, 2.0f, 3.0f), point3f(1.0f, 2.0f, 3.0f) };
+		octreef oct(cloud, 2, 1);
+		point3f query(0.0f, 0.0f, 0.0f);
+		neighbor<float> padded[3];
+		oct.nearest(&query, 1, 3, padded);
+		assert(padded[0].distance_squared == 14.0f && padded[1].distance_squared == 14.0f);
+		assert(padded[2].index == std::numeric_limits<std::uint32_t>::max() && std::isinf(padded[2].distance_squared));
+
+		std::vector<neighbor<float>> within;
+		octreef().within(query, 10.0f, within);
+		assert(within.empty());
+	}
+
+	std::cout << "All tests completed successfully.\n";
+
+	return 0;
+}